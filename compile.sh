@@ -1,2 +1,2 @@
-gcc gol.c -lm
+gcc -O3 gol.c -lm -pthread
 ./a.out
@@ -8,6 +8,12 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <termios.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <time.h>
 
 /*
 * This table holds binary to character mappings for display, it uses a unicode character set to represent pixels.
@@ -66,6 +72,12 @@ typedef struct {
 #define SCREEN_SUCCESS_BIT (SCREEN_SUCCESS << 8)
 #define SCREEN_ERROR_BIT   (SCREEN_ERROR << 8)
 
+/**
+* Screen option flags
+* SCREEN_SELF_RENDER is set by a drawer that keeps the glyphs up to date itself
+*/
+#define SCREEN_SELF_RENDER 0b00000001
+
 /**
 * @brief combines the status and data return into a single value
 * @param status the current return code of the function
@@ -197,15 +209,19 @@ uint16_t setScreenPixel(Screen *scr, uint8_t x, uint8_t y, bool value) {
 }
 
 /**
-* @brief renders the pixels to a character grid 1/6 the size
+* @brief renders a range of character rows of the pixels to the character grid
 * @param scr a pointer to the current screen
-* @return a pointer to the array
+* @param first the first character row
+* @param last one past the last character row
 */
-void renderScreen(Screen *scr) {
+void renderScreenRows(Screen *scr, int first, int last) {
     uint8_t width = (scr->width/2)+1;
     uint8_t height = (scr->height/3)+1;
+    if (last > height) {
+        last = height;
+    }
 
-    for (int y = 0; y < height; y++) {
+    for (int y = first; y < last; y++) {
         for (int x = 0; x < width; x++) {
             uint16_t index = (y*width)+x;
             bool inp[6];
@@ -220,6 +236,38 @@ void renderScreen(Screen *scr) {
     }
 }
 
+/**
+* @brief renders the pixels to a character grid 1/6 the size
+* @param scr a pointer to the current screen
+* @return a pointer to the array
+*/
+void renderScreen(Screen *scr) {
+    renderScreenRows(scr, 0, (scr->height/3)+1);
+}
+
+/**
+* @brief scrolls the pixels and the rendered characters up by whole character rows,
+*        the rows uncovered at the bottom are cleared
+* @param scr a pointer to the current screen
+* @param rows the number of character rows to scroll
+*/
+void scrollScreen(Screen *scr, uint8_t rows) {
+    size_t width = scr->width;
+    size_t height = scr->height;
+    size_t pixels = (size_t) rows * 3;
+    if (pixels > height) {
+        pixels = height;
+    }
+    memmove(scr->data, scr->data + (pixels * width), (height - pixels) * width * sizeof(bool));
+    memset(scr->data + ((height - pixels) * width), 0, pixels * width * sizeof(bool));
+
+    size_t cwidth = (width/2)+1;
+    size_t cheight = (height/3)+1;
+    size_t chars = (rows < cheight) ? rows : cheight;
+    memmove(scr->render, scr->render + (chars * cwidth), (cheight - chars) * cwidth);
+    memset(scr->render + ((cheight - chars) * cwidth), 0, chars * cwidth);
+}
+
 // TODO: document terminal IO functions
 
 // terminal control functions
@@ -342,93 +390,7817 @@ char getch() {
     return 0;  // No character available
 }
 
+/*
+* Work sharing for the heavier kernels. Tasks are handed out through an atomic
+* counter, the calling thread takes part so a single task never spawns anything.
+*/
+#define MAX_THREADS 256
+
+int thread_count = 1;  // set from the CPU count in main(), -t overrides it
+
+typedef struct {
+    void (*fn)(int task, void *arg);
+    void *arg;
+    int tasks;
+    atomic_int next;
+} ParallelJob;
+
+void *parallel_worker(void *ptr) {
+    ParallelJob *job = (ParallelJob*) ptr;
+    int task;
+    while ((task = atomic_fetch_add(&job->next, 1)) < job->tasks) {
+        job->fn(task, job->arg);
+    }
+    return NULL;
+}
+
+/**
+* @brief runs fn for every task index in 0..tasks-1 across up to thread_count threads
+* @param tasks the number of tasks
+* @param fn the function to run for each task
+* @param arg passed through to fn
+*/
+void run_parallel(int tasks, void (*fn)(int task, void *arg), void *arg) {
+    ParallelJob job;
+    job.fn = fn;
+    job.arg = arg;
+    job.tasks = tasks;
+    atomic_init(&job.next, 0);
+
+    pthread_t threads[MAX_THREADS];
+    int spawned = 0;
+    int wanted = (thread_count < tasks) ? thread_count : tasks;
+    for (int i = 1; i < wanted && i < MAX_THREADS; i++) {
+        if (pthread_create(&threads[spawned], NULL, parallel_worker, &job) != 0) {
+            break; // whatever could not be spawned is picked up by the others
+        }
+        spawned++;
+    }
+    parallel_worker(&job);
+    for (int i = 0; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+/*
+* Engine type, each simulation mode fills one of these in so main() can drive it.
+* init receives the arguments following the engine name on the command line.
+*/
+struct Board;
+struct Rule;
+struct StepStats;
+struct Edit;
+
+typedef struct {
+    const char *name;
+    const char *usage;
+    bool (*init)(int argc, char **argv);
+    void (*step)();
+    void (*draw)(Screen *scr);
+    void (*destroy)();
+    void (*key)(char ch);  // optional, NULL if the engine takes no keys
+    void (*report)();      // optional, prints results after a headless run
+    long (*skip)(long gens);  // optional, skips up to gens generations known to repeat
+    const struct Board *(*board)(const struct Rule **rule);  // optional, the live board for object labels
+    const struct StepStats *(*stats)();  // optional, population, births and deaths of the last step
+    void (*edit)(const struct Edit *e);  // optional, applies an edit between generations
+} Engine;
+
+// board size used by the resizable engines, set with -s WxH
+int board_width = 100;
+int board_height = 100;
+
+// the classic board, run_gol writes each generation over the one before
 bool gol_map[100*100];
-bool gol_last[100*100];
+long gol_gen;
 
 int gol_index(int x, int y) {
     return (y*100)+x;
 }
 
-int count_neighbors(int x, int y) {
-    int count = 0;
-    if (gol_last[gol_index(x-1, y)])
-        count++;
-    if (gol_last[gol_index(x+1, y)]) 
-        count++;
-    if (gol_last[gol_index(x, y-1)]) 
-        count++;
-    if (gol_last[gol_index(x, y+1)]) 
-        count++;
-    if (gol_last[gol_index(x-1, y-1)]) 
-        count++;
-    if (gol_last[gol_index(x-1, y+1)]) 
-        count++;
-    if (gol_last[gol_index(x+1, y-1)]) 
-        count++;
-    if (gol_last[gol_index(x+1, y+1)]) 
-        count++;
-    return count;
+// 16 cells of a row as bytes, the bool layout of the classic board, one SSE2 or NEON register
+typedef int8_t CellBytes __attribute__((vector_size(16)));
+
+/**
+* @brief loads 16 cells of a row from x on
+*/
+static inline CellBytes cell_bytes(const bool *row, int x) {
+    CellBytes v;
+    memcpy(&v, &row[x], sizeof(v));
+    return v;
+}
+
+/**
+* @brief steps the inner cells of one row from the rows above, at and below it
+* @param out receives the row, its edge cells are left as they are, it may not be
+* one of the rows read
+*
+* The neighbours of 16 cells are summed at once from byte vectors shifted by a cell,
+* and the rule is applied with vector compares. The last block is moved back to end
+* at the last inner cell, so a few cells are simply worked out twice.
+*/
+void gol_row(const bool *above, const bool *row, const bool *below, bool *out) {
+    const int lanes = (int) sizeof(CellBytes);
+    for (int x = 1; x < 99; x += lanes) {
+        int x0 = (x + lanes <= 99) ? x : 99 - lanes;
+        CellBytes c = cell_bytes(row, x0);
+        CellBytes n = cell_bytes(above, x0-1) + cell_bytes(above, x0) + cell_bytes(above, x0+1)
+                      + cell_bytes(row, x0-1) + cell_bytes(row, x0+1)
+                      + cell_bytes(below, x0-1) + cell_bytes(below, x0) + cell_bytes(below, x0+1);
+        CellBytes next = ((n == 3) & 1) | ((n == 2) & c);
+        memcpy(&out[x0], &next, sizeof(next));
+    }
 }
 
 void run_gol() {
-    memcpy(gol_map, gol_last, 100*100);
-
+    // rows are written over in place, the old row above and the old row being
+    // written are kept in two scratch rows that take turns
+    bool scratch[2][100];
+    bool *above = scratch[0];
+    bool *row = scratch[1];
+    memcpy(above, &gol_map[gol_index(0, 0)], 100);
     for (int y = 1; y < 99; y++) {
-        for (int x = 1; x < 99; x++) {
-            int n = count_neighbors(x,y);
-            bool state = gol_last[gol_index(x,y)];
-            if (state) {
-                state = false;
-                if (n == 2 || n == 3) {
-                    state = true;
-                }
-            } else {
-                if (n == 3) {
-                    state = true;
-                }
-            }
-            gol_map[gol_index(x,y)] = state;
+        memcpy(row, &gol_map[gol_index(0, y)], 100);
+        gol_row(above, row, &gol_map[gol_index(0, y+1)], &gol_map[gol_index(0, y)]);
+        bool *t = above;
+        above = row;
+        row = t;
+    }
+}
+
+/*
+* History of the classic board. Every generation is packed to bits and stored in a
+* fixed pool as a record of a presence bitmap followed by the nonzero words of its
+* XOR against the last keyframe, so quiet generations take a few words and any kept
+* generation is rebuilt from two records. Keyframes are simply XORs against nothing.
+* The pool is a ring, the oldest keyframe group is dropped when it is overwritten.
+*/
+#define GOL_WORDS       ((100*100 + 63) / 64)
+#define GOL_MASK_WORDS  ((GOL_WORDS + 63) / 64)
+#define HISTORY_POOL    (1 << 16)  // words in the record pool, 512KB
+#define HISTORY_FRAMES  4096       // generations indexed at most
+#define HISTORY_KEY     32         // a keyframe every HISTORY_KEY generations
+
+typedef struct {
+    int offset;  // first word of the record in the pool
+    int length;  // words in the record
+    bool key;
+} HistoryFrame;
+
+uint64_t history_pool[HISTORY_POOL];
+HistoryFrame history_frames[HISTORY_FRAMES];  // generation g is kept at g % HISTORY_FRAMES
+uint64_t history_key[GOL_WORDS];              // the packed last keyframe
+long history_first;   // oldest generation kept
+long history_last;    // newest generation kept, history_first-1 when empty
+long history_view;    // generation shown in the TUI, -1 when live
+bool history_cells[100*100];
+
+/**
+* @brief packs 100x100 cells into bits
+*
+* Eight 0/1 bytes are gathered at once, the multiply moves byte i to bit 56+i.
+*/
+void gol_pack(const bool *cells, uint64_t *words) {
+    memset(words, 0, GOL_WORDS * sizeof(uint64_t));
+    for (int i = 0; i < 100*100; i += 8) {
+        uint64_t bytes;
+        memcpy(&bytes, &cells[i], 8);
+        words[i >> 6] |= ((bytes * 0x0102040810204080ULL) >> 56) << (i & 63);
+    }
+}
+
+/**
+* @brief unpacks bits into 100x100 cells
+*/
+void gol_unpack(const uint64_t *words, bool *cells) {
+    for (int i = 0; i < 100*100; i++) {
+        cells[i] = (words[i >> 6] >> (i & 63)) & 1;
+    }
+}
+
+/**
+* @brief drops the oldest generations whose records overlap a pool range
+*
+* A whole keyframe group is dropped at once, its deltas are useless without it.
+*/
+void history_evict(int offset, int length) {
+    while (history_first <= history_last) {
+        HistoryFrame *f = &history_frames[history_first % HISTORY_FRAMES];
+        if (f->offset >= offset + length || f->offset + f->length <= offset) {
+            break;
         }
+        do {
+            history_first++;
+        } while (history_first <= history_last
+                 && !history_frames[history_first % HISTORY_FRAMES].key);
     }
+}
 
-    memcpy(gol_last, gol_map, 100*100);
+/**
+* @brief builds the record of a generation
+* @param words the packed cells
+* @param key true for a keyframe, false for a delta against history_key
+* @param record receives the presence bitmap followed by the nonzero words
+* @return the words in the record
+*/
+int history_record(const uint64_t *words, bool key, uint64_t *record) {
+    int length = GOL_MASK_WORDS;
+    memset(record, 0, GOL_MASK_WORDS * sizeof(uint64_t));
+    for (int w = 0; w < GOL_WORDS; w++) {
+        uint64_t d = key ? words[w] : words[w] ^ history_key[w];
+        if (d) {
+            record[w >> 6] |= 1ULL << (w & 63);
+            record[length++] = d;
+        }
+    }
+    return length;
 }
 
-int main() {
-    uint16_t ret;
-    bool running = true;
+/**
+* @brief stores a generation, it must follow the newest one kept
+* @param gen the generation number
+* @param cells the 100x100 cells
+*/
+void history_push(long gen, const bool *cells) {
+    uint64_t words[GOL_WORDS];
+    gol_pack(cells, words);
 
-    // load temporary stdout buffer
-    init_term();
+    if (history_first > history_last) {
+        history_first = gen;
+    }
+    bool key = (gen == history_first) || (gen % HISTORY_KEY == 0);
+    if (history_last - history_first + 1 >= HISTORY_FRAMES) {
+        HistoryFrame *oldest = &history_frames[history_first % HISTORY_FRAMES];
+        history_evict(oldest->offset, 1);
+    }
 
-    // current screen instance
-    Screen scr;
+    // the record goes right after the newest one, wrapping to the start of the pool
+    uint64_t record[GOL_MASK_WORDS + GOL_WORDS];
+    int length = history_record(words, key, record);
+    int offset = 0;
+    if (history_first <= history_last) {
+        HistoryFrame *prev = &history_frames[history_last % HISTORY_FRAMES];
+        offset = prev->offset + prev->length;
+        if (offset + length > HISTORY_POOL) {
+            history_evict(offset, HISTORY_POOL - offset);  // the oldest records sit in the tail
+            offset = 0;
+        }
+        history_evict(offset, length);
+    }
+    if (history_first > history_last && !key) {
+        // everything older was overwritten, so this one has to stand on its own
+        key = true;
+        length = history_record(words, key, record);
+        offset = 0;
+    }
+    if (key) {
+        memcpy(history_key, words, sizeof(words));
+    }
 
-    if (returnError(initScreen(&scr, 0x0, 100, 100))) {
-        exit(1);
+    memcpy(&history_pool[offset], record, length * sizeof(uint64_t));
+    history_frames[gen % HISTORY_FRAMES] = (HistoryFrame) { offset, length, key };
+    if (history_first > history_last) {
+        history_first = gen;
     }
-    srand(0);
-    for (int y = 0; y < 100; y++) {
-        for (int x = 0; x < 100; x++) {
-            gol_last[(y*100)+x] = (bool) (rand() % 2)-1;
+    history_last = gen;
+}
+
+/**
+* @brief applies a record to packed cells
+*/
+void history_apply(const HistoryFrame *f, uint64_t *words) {
+    const uint64_t *mask = &history_pool[f->offset];
+    const uint64_t *value = mask + GOL_MASK_WORDS;
+    for (int w = 0; w < GOL_WORDS; w++) {
+        if ((mask[w >> 6] >> (w & 63)) & 1) {
+            words[w] ^= *value++;
         }
     }
+}
 
-    while (running) {
-        // GOL loop
-        run_gol();
-        for (int y = 0; y < 100; y++) {
-            for (int x = 0; x < 100; x++) {
-                setScreenPixel(&scr, x,y, gol_map[(y*100)+x]);
+/**
+* @brief rebuilds a kept generation from its keyframe and its delta
+* @param gen the generation
+* @param cells receives the 100x100 cells
+* @return false if the generation is not kept
+*/
+bool history_get(long gen, bool *cells) {
+    if (gen < history_first || gen > history_last) {
+        return false;
+    }
+    long key = gen;
+    while (!history_frames[key % HISTORY_FRAMES].key) {
+        key--;
+    }
+    uint64_t words[GOL_WORDS] = { 0 };
+    history_apply(&history_frames[key % HISTORY_FRAMES], words);
+    if (key != gen) {
+        history_apply(&history_frames[gen % HISTORY_FRAMES], words);
+    }
+    gol_unpack(words, cells);
+    return true;
+}
+
+/**
+* @brief forgets every generation after gen, so stepping can continue from it
+*/
+void history_truncate(long gen) {
+    if (gen >= history_last) {
+        return;
+    }
+    history_last = (gen >= history_first) ? gen : history_first-1;
+    if (history_first <= history_last) {
+        long key = history_last;
+        while (!history_frames[key % HISTORY_FRAMES].key) {
+            key--;
+        }
+        memset(history_key, 0, sizeof(history_key));
+        history_apply(&history_frames[key % HISTORY_FRAMES], history_key);
+    }
+}
+
+
+/*
+* Bit packed board, bit i of word w in a row holds the cell at x = (w*64)+i.
+* One dead row is kept above and below the board and the bits past the width are
+* always zero, so the kernels never need to bounds check. Cells outside are dead.
+*/
+typedef struct Board {
+    int width;
+    int height;
+    int words;       // 64 bit words per row
+    uint64_t *data;  // (height+2) * words, including the two dead rows
+} Board;
+
+/**
+* @brief initializes and allocates an empty Board
+* @param b a pointer to the board
+* @param width the width of the board in cells
+* @param height the height of the board in cells
+* @return true if the memory was allocated
+*/
+bool board_init(Board *b, int width, int height) {
+    b->width = width;
+    b->height = height;
+    b->words = (width+63) / 64;
+    b->data = (uint64_t*) calloc((size_t) (height+2) * b->words, sizeof(uint64_t));
+    if (!b->data) {
+        fprintf(stderr, "Error allocating memory for a %dx%d board\n", width, height);
+        return false;
+    }
+    return true;
+}
+
+/**
+* @brief frees the memory of a Board
+* @param b a pointer to the board
+*/
+void board_destroy(Board *b) {
+    if (b->data) {
+        free(b->data);
+        b->data = NULL;
+    }
+}
+
+/**
+* @brief gets a row of a board, rows -1 and height are the dead rows
+* @param b a pointer to the board
+* @param y the row
+* @return a pointer to the first word of the row
+*/
+uint64_t *board_row(const Board *b, int y) {
+    return &b->data[(size_t) (y+1) * b->words];
+}
+
+/**
+* @brief returns the mask of valid cells in the last word of a row
+* @param b a pointer to the board
+* @return the mask of bits inside the board width
+*/
+uint64_t board_last_mask(const Board *b) {
+    int bits = b->width & 63;
+    return bits ? ((1ULL << bits) - 1) : ~0ULL;
+}
+
+/**
+* @brief gets a cell, cells outside the board are dead
+* @param b a pointer to the board
+* @param x the x position of the cell
+* @param y the y position of the cell
+* @return the cell value
+*/
+bool board_get(const Board *b, int x, int y) {
+    if (x < 0 || x >= b->width || y < 0 || y >= b->height) {
+        return false;
+    }
+    return (board_row(b, y)[x >> 6] >> (x & 63)) & 1;
+}
+
+/**
+* @brief sets a cell, cells outside the board are ignored
+* @param b a pointer to the board
+* @param x the x position of the cell
+* @param y the y position of the cell
+* @param value the new cell value
+*/
+void board_set(Board *b, int x, int y, bool value) {
+    if (x < 0 || x >= b->width || y < 0 || y >= b->height) {
+        return;
+    }
+    uint64_t bit = 1ULL << (x & 63);
+    if (value) {
+        board_row(b, y)[x >> 6] |= bit;
+    } else {
+        board_row(b, y)[x >> 6] &= ~bit;
+    }
+}
+
+/*
+* Region kernels on packed boards, for the clipboard and for symmetric soups. Turns
+* and mirrors are a transpose followed by flips, with orientations numbered as for the
+* apgcodes: bit 2 transposes first, then bit 0 flips x and bit 1 flips y, so 5 turns a
+* quarter clockwise, 3 a half and 6 a quarter anticlockwise. The transpose works on
+* 64x64 blocks with the usual bit matrix transpose, 6 rounds of masked swaps over
+* whole words. Flipping x reverses the bits of every word. Every kernel is spread over
+* the thread pool, by blocks or by bands of rows.
+*/
+#define PASTE_OR    0
+#define PASTE_XOR   1
+#define PASTE_AND   2
+#define PASTE_COPY  3
+
+Board clipboard;  // empty while data is NULL
+
+/**
+* @brief transposes a 64x64 bit matrix in place, bit x of a[y] goes to bit y of a[x]
+*/
+void transpose64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+/**
+* @brief reverses the bits of a word
+*/
+static inline uint64_t bit_reverse(uint64_t v) {
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(v);
+}
+
+/**
+* @brief reads 64 cells of a row from x on, cells outside the board are dead
+*/
+uint64_t board_bits(const Board *b, int y, int x) {
+    if (y < 0 || y >= b->height || x >= b->width || x <= -64) {
+        return 0;
+    }
+    const uint64_t *row = board_row(b, y);
+    int w = (x >= 0) ? x >> 6 : -1;
+    int s = x & 63;
+    uint64_t lo = (w >= 0) ? row[w] : 0;
+    uint64_t hi = (w+1 < b->words) ? row[w+1] : 0;
+    return s ? (lo >> s) | (hi << (64 - s)) : lo;
+}
+
+typedef struct {
+    const Board *src;
+    Board *dst;
+    int x, y;   // where the region starts on the bigger board
+    int mode;   // PASTE_ mode
+    int rows;   // rows per band
+} RegionJob;
+
+/**
+* @brief runs a row task over bands of at least 4096 words, so small boards stay on
+* one thread
+*/
+void run_row_bands(int height, int words, void (*fn)(int task, void *arg), RegionJob *job) {
+    if (height <= 0) {
+        return;
+    }
+    int bands = (int) (((long) height * words) / 4096);
+    bands = (bands < 1) ? 1 : (bands > thread_count * 4) ? thread_count * 4 : bands;
+    job->rows = (height + bands - 1) / bands;
+    run_parallel((height + job->rows - 1) / job->rows, fn, job);
+}
+
+/**
+* @brief transposes the 64x64 blocks of one band of 64 source rows
+*/
+void transpose_task(int task, void *arg) {
+    RegionJob *job = (RegionJob*) arg;
+    const Board *src = job->src;
+    Board *dst = job->dst;
+    for (int bx = 0; bx < src->words; bx++) {
+        uint64_t block[64];
+        for (int i = 0; i < 64; i++) {
+            int y = (task * 64) + i;
+            block[i] = (y < src->height) ? board_row(src, y)[bx] : 0;
+        }
+        transpose64(block);
+        for (int i = 0; i < 64 && (bx * 64) + i < dst->height; i++) {
+            board_row(dst, (bx * 64) + i)[task] = block[i];
+        }
+    }
+}
+
+/**
+* @brief transposes a board into another, dst has to be height x width
+*/
+void board_transpose(const Board *src, Board *dst) {
+    RegionJob job = { .src = src, .dst = dst };
+    run_parallel(dst->words, transpose_task, &job);
+    for (int y = 0; y < dst->height; y++) {
+        board_row(dst, y)[dst->words-1] &= board_last_mask(dst);
+    }
+}
+
+/**
+* @brief mirrors one band of rows left to right, reversing the words and their bits
+*/
+void flip_x_task(int task, void *arg) {
+    RegionJob *job = (RegionJob*) arg;
+    Board *b = job->dst;
+    int y1 = ((task + 1) * job->rows < b->height) ? (task + 1) * job->rows : b->height;
+    int pad = (b->words * 64) - b->width;
+    for (int y = task * job->rows; y < y1; y++) {
+        uint64_t *row = board_row(b, y);
+        for (int a = 0, c = b->words-1; a <= c; a++, c--) {
+            uint64_t t = bit_reverse(row[a]);
+            row[a] = bit_reverse(row[c]);
+            row[c] = t;
+        }
+        // the reversed row starts with the padding of the last word
+        for (int w = 0; pad && w < b->words; w++) {
+            row[w] = (row[w] >> pad) | ((w+1 < b->words) ? row[w+1] << (64 - pad) : 0);
+        }
+    }
+}
+
+/**
+* @brief mirrors a board left to right in place
+*/
+void board_flip_x(Board *b) {
+    RegionJob job = { .dst = b };
+    run_row_bands(b->height, b->words, flip_x_task, &job);
+}
+
+/**
+* @brief swaps one band of rows of the top half with their mirror rows
+*/
+void flip_y_task(int task, void *arg) {
+    RegionJob *job = (RegionJob*) arg;
+    Board *b = job->dst;
+    int y1 = ((task + 1) * job->rows < b->height / 2) ? (task + 1) * job->rows : b->height / 2;
+    for (int y = task * job->rows; y < y1; y++) {
+        uint64_t *a = board_row(b, y);
+        uint64_t *c = board_row(b, b->height-1-y);
+        for (int w = 0; w < b->words; w++) {
+            uint64_t t = a[w];
+            a[w] = c[w];
+            c[w] = t;
+        }
+    }
+}
+
+/**
+* @brief mirrors a board top to bottom in place
+*/
+void board_flip_y(Board *b) {
+    RegionJob job = { .dst = b };
+    run_row_bands(b->height / 2, b->words, flip_y_task, &job);
+}
+
+/**
+* @brief turns or mirrors a board in place
+* @param orient bit 2 transposes first, then bit 0 flips x and bit 1 flips y
+* @return false if memory ran out, the board is left as it was
+*/
+bool board_orient(Board *b, int orient) {
+    if (orient & 4) {
+        Board t;
+        if (!board_init(&t, b->height, b->width)) {
+            return false;
+        }
+        board_transpose(b, &t);
+        board_destroy(b);
+        *b = t;
+    }
+    if (orient & 1) {
+        board_flip_x(b);
+    }
+    if (orient & 2) {
+        board_flip_y(b);
+    }
+    return true;
+}
+
+/**
+* @brief copies one band of rows of a region
+*/
+void copy_region_task(int task, void *arg) {
+    RegionJob *job = (RegionJob*) arg;
+    Board *dst = job->dst;
+    int y1 = ((task + 1) * job->rows < dst->height) ? (task + 1) * job->rows : dst->height;
+    for (int r = task * job->rows; r < y1; r++) {
+        uint64_t *row = board_row(dst, r);
+        for (int k = 0; k < dst->words; k++) {
+            row[k] = board_bits(job->src, job->y + r, job->x + (k * 64));
+        }
+        row[dst->words-1] &= board_last_mask(dst);
+    }
+}
+
+/**
+* @brief copies a region of a board into a new board, cells outside are dead
+* @return false if memory ran out
+*/
+bool board_copy_region(const Board *src, int x, int y, int w, int h, Board *dst) {
+    if (!board_init(dst, w, h)) {
+        return false;
+    }
+    RegionJob job = { .src = src, .dst = dst, .x = x, .y = y };
+    run_row_bands(h, dst->words, copy_region_task, &job);
+    return true;
+}
+
+/**
+* @brief combines a word into a board word under a mask of the cells it covers
+*/
+static inline uint64_t paste_word(uint64_t t, uint64_t v, uint64_t m, int mode) {
+    switch (mode) {
+        case PASTE_XOR:
+            return t ^ v;
+        case PASTE_AND:
+            return t & (v | ~m);
+        case PASTE_COPY:
+            return (t & ~m) | v;
+        default:
+            return t | v;
+    }
+}
+
+/**
+* @brief pastes one band of rows of the pasted board
+*/
+void paste_task(int task, void *arg) {
+    RegionJob *job = (RegionJob*) arg;
+    const Board *src = job->src;
+    Board *dst = job->dst;
+    int s = job->x & 63;
+    int w0 = (job->x >= 0) ? job->x >> 6 : -((-job->x + 63) >> 6);
+    int r1 = ((task + 1) * job->rows < src->height) ? (task + 1) * job->rows : src->height;
+    for (int r = task * job->rows; r < r1; r++) {
+        if (job->y + r < 0 || job->y + r >= dst->height) {
+            continue;
+        }
+        const uint64_t *from = board_row(src, r);
+        uint64_t *row = board_row(dst, job->y + r);
+        for (int k = 0; k < src->words; k++) {
+            uint64_t m = (k == src->words-1) ? board_last_mask(src) : ~0ULL;
+            uint64_t v = from[k] & m;
+            int w = w0 + k;
+            if (w >= 0 && w < dst->words) {
+                row[w] = paste_word(row[w], v << s, m << s, job->mode);
+            }
+            if (s && w+1 >= 0 && w+1 < dst->words) {
+                row[w+1] = paste_word(row[w+1], v >> (64 - s), m >> (64 - s), job->mode);
             }
         }
-        // render
-        renderScreen(&scr);
-        printScreen(&scr);
+        row[dst->words-1] &= board_last_mask(dst);
+    }
+}
+
+/**
+* @brief pastes a board onto another with its top left at x, y
+* @param mode one of the PASTE_ modes, cells outside the pasted board are kept
+*/
+void board_paste(Board *dst, const Board *src, int x, int y, int mode) {
+    RegionJob job = { .src = src, .dst = dst, .x = x, .y = y, .mode = mode };
+    run_row_bands(src->height, src->words, paste_task, &job);
+}
+
+/*
+* Counter based random numbers (Philox4x32-10). The output is a pure function of the
+* key and the counter, so every word of a board can draw its own bits from
+* (seed, generation, position) in any order and on any number of threads and still
+* get the same numbers.
+*/
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+/**
+* @brief computes one Philox4x32-10 block
+* @param ctr the 128 bit counter
+* @param seed the 64 bit key
+* @param out receives two 64 bit random words
+*/
+static inline void philox(const uint32_t ctr[4], uint64_t seed, uint64_t out[2]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = (uint32_t) seed, k1 = (uint32_t) (seed >> 32);
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = ((uint64_t) c1 << 32) | c0;
+    out[1] = ((uint64_t) c3 << 32) | c2;
+}
+
+#define CHANCE_BITS 16
+#define CHANCE_ONE  (1u << CHANCE_BITS)
+
+/**
+* @brief makes a word whose bits are each set with a given chance
+*
+* Walking the binary fraction of the chance from its lowest set bit, each 1 ORs in a
+* fresh random word and each 0 ANDs one in, which half-fills or halves the density
+* at each step and lands exactly on the fraction.
+* @param chance the chance in 1/CHANCE_ONE units
+* @param seed the key of the generator
+* @param ctr the counter, ctr[3] numbers the draws and is restored on return
+* @return the random mask
+*/
+uint64_t random_mask(uint32_t chance, uint64_t seed, uint32_t ctr[4]) {
+    if (chance >= CHANCE_ONE) {
+        return ~0ULL;
+    }
+    if (chance == 0) {
+        return 0;
+    }
+    uint64_t acc = 0;
+    uint64_t words[2];
+    int drawn = 0;
+    uint32_t base = ctr[3];
+    for (int i = __builtin_ctz(chance); i < CHANCE_BITS; i++) {
+        if (!(drawn & 1)) {
+            ctr[3] = base + (drawn / 2);
+            philox(ctr, seed, words);
+        }
+        uint64_t r = words[drawn & 1];
+        drawn++;
+        acc = ((chance >> i) & 1) ? (acc | r) : (acc & r);
+    }
+    ctr[3] = base;
+    return acc;
+}
+
+/**
+* @brief converts a probability to CHANCE_ONE units
+* @param p the probability between 0 and 1
+* @return the rounded chance
+*/
+uint32_t chance_from(double p) {
+    if (p <= 0) {
+        return 0;
+    }
+    if (p >= 1) {
+        return CHANCE_ONE;
+    }
+    return (uint32_t) ((p * CHANCE_ONE) + 0.5);
+}
+
+/*
+* Random soups. Cells are drawn 64 at a time from the counter based generator with
+* the density built from its binary fraction, so a soup depends only on the seed and
+* the density, never on the thread count. Set with -d, -S and -Y in main().
+*/
+#define SYMMETRY_C1 1
+#define SYMMETRY_C2 2
+#define SYMMETRY_C4 4
+#define SYMMETRY_D8 8
+
+typedef struct {
+    uint32_t density;  // in CHANCE_ONE units
+    uint64_t seed;
+    int symmetry;      // one of the SYMMETRY_ defines
+} Soup;
+
+Soup soup = { CHANCE_ONE / 2, 0, SYMMETRY_C1 };
+
+/**
+* @brief parses a density such as 0.375, 3/8 or 37.5%
+* @param str the density string
+* @param density where to store the density in CHANCE_ONE units
+* @return true if the density was valid
+*/
+bool parse_density(const char *str, uint32_t *density) {
+    double num, den;
+    char c;
+    double p;
+    if (sscanf(str, "%lf/%lf%c", &num, &den, &c) == 2 && den > 0) {
+        p = num / den;
+    } else if (sscanf(str, "%lf%c%c", &num, &c, &c) == 2 && c == '%') {
+        p = num / 100;
+    } else if (sscanf(str, "%lf%c", &num, &c) == 1) {
+        p = num;
+    } else {
+        fprintf(stderr, "[E] Invalid density: %s\n", str);
+        return false;
+    }
+    if (p < 0 || p > 1) {
+        fprintf(stderr, "[E] Density out of range: %s\n", str);
+        return false;
+    }
+    *density = chance_from(p);
+    return true;
+}
+
+/**
+* @brief parses a soup symmetry, one of C1, C2, C4 or D8
+* @param str the symmetry string
+* @param symmetry where to store the symmetry
+* @return true if the symmetry was known
+*/
+bool parse_symmetry(const char *str, int *symmetry) {
+    if (strcmp(str, "C1") == 0) {
+        *symmetry = SYMMETRY_C1;
+    } else if (strcmp(str, "C2") == 0) {
+        *symmetry = SYMMETRY_C2;
+    } else if (strcmp(str, "C4") == 0) {
+        *symmetry = SYMMETRY_C4;
+    } else if (strcmp(str, "D8") == 0) {
+        *symmetry = SYMMETRY_D8;
+    } else {
+        fprintf(stderr, "[E] Unknown symmetry: %s\n", str);
+        return false;
+    }
+    return true;
+}
+
+/**
+* @brief draws one word of a soup
+* @param soup the soup settings
+* @param w the word in the row
+* @param y the row
+* @return 64 random cells
+*/
+uint64_t soup_word(const Soup *soup, int w, int y) {
+    // generation 0 of the counter, the stochastic rules only draw from 1 onwards
+    uint32_t ctr[4] = { (uint32_t) w, (uint32_t) y, 0, 0 };
+    return random_mask(soup->density, soup->seed, ctr);
+}
+
+/**
+* @brief returns the bits lo to hi-1 of a word
+*/
+static inline uint64_t span_mask(int lo, int hi) {
+    uint64_t below_hi = (hi >= 64) ? ~0ULL : ((1ULL << hi) - 1);
+    return below_hi & ~((1ULL << lo) - 1);
+}
+
+typedef struct {
+    Board *board;
+    const Soup *soup;
+    int x0, y0, x1, y1;
+    int rows;  // rows per band
+} SoupJob;
+
+/**
+* @brief fills one band of rows of a soup region
+*/
+void soup_task(int task, void *arg) {
+    SoupJob *job = (SoupJob*) arg;
+    int y0 = job->y0 + (task * job->rows);
+    int y1 = (y0 + job->rows < job->y1) ? y0 + job->rows : job->y1;
+    for (int y = y0; y < y1; y++) {
+        uint64_t *row = board_row(job->board, y);
+        for (int w = job->x0 >> 6; w <= (job->x1 - 1) >> 6; w++) {
+            int lo = (job->x0 > w*64) ? job->x0 - (w*64) : 0;
+            int hi = (job->x1 < (w+1)*64) ? job->x1 - (w*64) : 64;
+            uint64_t m = span_mask(lo, hi);
+            row[w] = (row[w] & ~m) | (soup_word(job->soup, w, y) & m);
+        }
+    }
+}
+
+/**
+* @brief gets the cells of a row that come first in their orbit under a symmetry,
+* in row order, they are a span of the row
+* @param symmetry one of the SYMMETRY_ defines, C4 and D8 need a square region
+* @param y the row inside the region
+* @param hi receives one past the last cell of the span
+* @return the first cell of the span, empty when it is not below hi
+*/
+int soup_span(int symmetry, int width, int height, int y, int *hi) {
+    int my = height-1-y;
+    if (symmetry == SYMMETRY_C1) {
+        *hi = width;
+        return 0;
+    }
+    if (symmetry == SYMMETRY_C2) {
+        *hi = (y < my) ? width : (y == my) ? ((width-1) / 2) + 1 : 0;
+        return 0;
+    }
+    // the first cell of a quarter turn orbit is in the top wedge, D8 also halves it
+    *hi = (y < my) ? my : (y == my) ? y+1 : y;
+    if (symmetry == SYMMETRY_D8 && *hi > ((width-1) / 2) + 1) {
+        *hi = ((width-1) / 2) + 1;
+    }
+    return y;
+}
+
+/**
+* @brief makes a filled region symmetric, every cell copies the first cell of its orbit
+*
+* Only the first cells are kept, then every image of them under the symmetry is
+* or'ed back in, each one made by the packed turns and flips of the clipboard.
+* @return false if memory ran out
+*/
+bool soup_symmetrize(Board *b, int symmetry, int x0, int y0, int width, int height) {
+    static const int images[][8] = {
+        [SYMMETRY_C2] = { 3 },
+        [SYMMETRY_C4] = { 3, 5, 6 },
+        [SYMMETRY_D8] = { 1, 2, 3, 4, 5, 6, 7 },
+    };
+    int count = (symmetry == SYMMETRY_C2) ? 1 : (symmetry == SYMMETRY_C4) ? 3 : 7;
+    Board first, turned = { 0 }, image;
+    if (!board_copy_region(b, x0, y0, width, height, &first)) {
+        return false;
+    }
+    if (!board_init(&image, width, height)) {
+        board_destroy(&first);
+        return false;
+    }
+    for (int y = 0; y < height; y++) {
+        int hi;
+        int lo = soup_span(symmetry, width, height, y, &hi);
+        uint64_t *row = board_row(&first, y);
+        for (int w = 0; w < first.words; w++) {
+            int a = (lo > w*64) ? lo - (w*64) : 0;
+            int c = (hi < (w+1)*64) ? hi - (w*64) : 64;
+            row[w] &= (c > a) ? span_mask(a, c) : 0;
+        }
+    }
+    board_paste(b, &first, x0, y0, PASTE_COPY);
+
+    // the regions of C4 and D8 are square, so the images that turn share one transpose
+    if (symmetry != SYMMETRY_C2) {
+        if (!board_init(&turned, height, width)) {
+            board_destroy(&first);
+            board_destroy(&image);
+            return false;
+        }
+        board_transpose(&first, &turned);
+    }
+    size_t bytes = (size_t) (height + 2) * first.words * sizeof(uint64_t);
+    for (int i = 0; i < count; i++) {
+        int o = images[symmetry][i];
+        memcpy(image.data, (o & 4) ? turned.data : first.data, bytes);
+        board_orient(&image, o & 3);  // flips only, they never allocate
+        board_paste(b, &image, x0, y0, PASTE_OR);
+    }
+    board_destroy(&first);
+    board_destroy(&turned);
+    board_destroy(&image);
+    return true;
+}
+
+/**
+* @brief fills a region of a board with a random soup
+* @param b a pointer to the board
+* @param soup the density, seed and symmetry of the soup
+* @param x the left edge of the region
+* @param y the top edge of the region
+* @param width the width of the region, clipped to the board
+* @param height the height of the region, clipped to the board
+* @return false if the symmetry needs a square region and did not get one, or if
+* memory ran out
+*/
+bool soup_fill(Board *b, const Soup *soup, int x, int y, int width, int height) {
+    SoupJob job = { b, soup, (x < 0) ? 0 : x, (y < 0) ? 0 : y, x + width, y + height, 0 };
+    job.x1 = (job.x1 > b->width) ? b->width : job.x1;
+    job.y1 = (job.y1 > b->height) ? b->height : job.y1;
+    width = job.x1 - job.x0;
+    height = job.y1 - job.y0;
+    if (width <= 0 || height <= 0) {
+        return true;
+    }
+    if ((soup->symmetry == SYMMETRY_C4 || soup->symmetry == SYMMETRY_D8) && width != height) {
+        fprintf(stderr, "[E] C4 and D8 soups need a square region, got %dx%d\n", width, height);
+        return false;
+    }
+
+    // bands of at least 4096 words so small soups stay on one thread
+    int bands = (int) (((long) height * ((width+63) / 64)) / 4096);
+    bands = (bands < 1) ? 1 : (bands > thread_count * 4) ? thread_count * 4 : bands;
+    job.rows = (height + bands - 1) / bands;
+    run_parallel((height + job.rows - 1) / job.rows, soup_task, &job);
+
+    if (soup->symmetry != SYMMETRY_C1) {
+        return soup_symmetrize(b, soup->symmetry, job.x0, job.y0, width, height);
+    }
+    return true;
+}
+
+/**
+* @brief draws a uniform value for a cell, for engines whose live cells take more
+* than one value
+* @return 32 random bits
+*/
+uint32_t soup_value(const Soup *soup, int x, int y) {
+    // a generation no rule draws from, so values never repeat the cells' own masks
+    uint32_t ctr[4] = { (uint32_t) x, (uint32_t) y, UINT32_MAX, 0 };
+    uint64_t out[2];
+    philox(ctr, soup->seed, out);
+    return (uint32_t) out[0];
+}
+
+/**
+* @brief seeds the classic 100x100 board with a random soup
+* @return true if the soup could be made, the classic engine takes no arguments
+*/
+bool life_init(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    Board b;
+    if (!board_init(&b, 100, 100)) {
+        return false;
+    }
+    bool ok = soup_fill(&b, &soup, 0, 0, 100, 100);
+    for (int y = 0; y < 100; y++) {
+        for (int x = 0; x < 100; x++) {
+            gol_map[(y*100)+x] = board_get(&b, x, y);
+        }
+    }
+    board_destroy(&b);
+
+    gol_gen = 0;
+    history_first = 0;
+    history_last = -1;
+    history_view = -1;
+    history_push(gol_gen, gol_map);
+    return ok;
+}
+
+/**
+* @brief advances the classic board and records the new generation, paused while
+* an older generation is shown
+*/
+void life_step() {
+    if (history_view >= 0) {
+        return;
+    }
+    run_gol();
+    gol_gen++;
+    history_push(gol_gen, gol_map);
+}
+
+/**
+* @brief moves through the history: , and . step back and forward, < and > move by
+* 50 generations, r rewinds to the oldest kept, l goes back live and c continues
+* live from the generation shown, forgetting the newer ones
+*/
+void life_key(char ch) {
+    long gen = (history_view >= 0) ? history_view : gol_gen;
+    switch (ch) {
+        case ',': gen -= 1; break;
+        case '.': gen += 1; break;
+        case '<': gen -= 50; break;
+        case '>': gen += 50; break;
+        case 'r': gen = history_first; break;
+        case 'l': gen = gol_gen; break;
+        case 'c':
+            if (history_view >= 0) {
+                history_truncate(history_view);
+                history_get(history_view, gol_map);
+                gol_gen = history_view;
+                history_view = -1;
+            }
+            return;
+        default: return;
+    }
+    gen = (gen < history_first) ? history_first : gen;
+    if (gen >= gol_gen) {
+        history_view = -1;
+    } else if (history_get(gen, history_cells)) {
+        history_view = gen;
+    }
+}
+
+/**
+* @brief copies the classic board, or the generation picked from the history, onto the screen
+* @param scr a pointer to the current screen
+*/
+void life_draw(Screen *scr) {
+    const bool *cells = (history_view >= 0) ? history_cells : gol_map;
+    for (int y = 0; y < 100; y++) {
+        for (int x = 0; x < 100; x++) {
+            setScreenPixel(scr, x,y, cells[(y*100)+x]);
+        }
+    }
+}
+
+void life_destroy() {
+}
+
+/*
+* Outer totalistic rule in B3/S23 form (S/B form such as 23/3 is also accepted).
+* A trailing H selects the hexagonal neighborhood and a trailing V the von Neumann one,
+* the way Golly writes them, otherwise the Moore neighborhood is used.
+*/
+#define NEIGHBORHOOD_MOORE   'M'
+#define NEIGHBORHOOD_HEX     'H'
+#define NEIGHBORHOOD_VN      'V'
+
+typedef struct Rule {
+    uint16_t birth;      // bit n set when a dead cell with n neighbors is born
+    uint16_t survive;    // bit n set when a live cell with n neighbors survives
+    char neighborhood;
+} Rule;
+
+/**
+* @brief the number of neighbors of a neighborhood
+* @param neighborhood one of the NEIGHBORHOOD_ defines
+* @return the neighbor count
+*/
+int neighborhood_size(char neighborhood) {
+    switch (neighborhood) {
+        case NEIGHBORHOOD_HEX: return 6;
+        case NEIGHBORHOOD_VN:  return 4;
+        default:               return 8;
+    }
+}
+
+/**
+* @brief parses a list of neighbor count digits into a bit mask
+* @param str the digits
+* @param len the number of characters to read
+* @param mask where to store the mask
+* @return true if every character was a digit
+*/
+bool parse_rule_digits(const char *str, int len, uint16_t *mask) {
+    *mask = 0;
+    for (int i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return false;
+        }
+        *mask |= 1 << (str[i] - '0');
+    }
+    return true;
+}
+
+/**
+* @brief parses an outer totalistic rule string
+* @param str the rule, for example B3/S23, B2/S34H or 23/3
+* @param rule where to store the parsed rule
+* @return true if the rule was valid
+*/
+bool parse_rule(const char *str, Rule *rule) {
+    Rule r = { 0, 0, NEIGHBORHOOD_MOORE };
+    int len = (int) strlen(str);
+    if (len > 0 && (str[len-1] == 'H' || str[len-1] == 'h')) {
+        r.neighborhood = NEIGHBORHOOD_HEX;
+        len--;
+    } else if (len > 0 && (str[len-1] == 'V' || str[len-1] == 'v')) {
+        r.neighborhood = NEIGHBORHOOD_VN;
+        len--;
+    }
+
+    const char *slash = memchr(str, '/', len);
+    bool ok = slash != NULL;
+    if (ok && (str[0] == 'B' || str[0] == 'b')) {
+        const char *s = slash + 1;
+        ok = (*s == 'S' || *s == 's')
+          && parse_rule_digits(str+1, (int) (slash-str) - 1, &r.birth)
+          && parse_rule_digits(s+1, len - (int) (s+1-str), &r.survive);
+    } else if (ok) {
+        ok = parse_rule_digits(str, (int) (slash-str), &r.survive)
+          && parse_rule_digits(slash+1, len - (int) (slash+1-str), &r.birth);
+    }
+    uint16_t valid = (uint16_t) ((2 << neighborhood_size(r.neighborhood)) - 1);
+    if (!ok || ((r.birth | r.survive) & ~valid)) {
+        fprintf(stderr, "[E] Invalid rule: %s\n", str);
+        return false;
+    }
+    *rule = r;
+    return true;
+}
+
+// bit-sliced adders, each bit position of the words is a separate cell, the words
+// take the type of the sum so vectors of them work as well
+#define HALF_ADD(s, c, a, b) do { __typeof__(s) _a = (a), _b = (b); \
+    s = _a ^ _b; c = _a & _b; } while (0)
+#define FULL_ADD(s, c, a, b, d) do { __typeof__(s) _a = (a), _b = (b), _d = (d), _t = _a ^ _b; \
+    s = _t ^ _d; c = (_a & _b) | (_t & _d); } while (0)
+
+/**
+* @brief applies a rule to bit-sliced neighbor counts
+* @param rule the rule to apply
+* @param alive the current cells
+* @param p0 bit 0 of the neighbor counts
+* @param p1 bit 1 of the neighbor counts
+* @param p2 bit 2 of the neighbor counts
+* @param p3 bit 3 of the neighbor counts
+* @return the next cells
+*/
+static inline uint64_t rule_apply(const Rule *rule, uint64_t alive,
+                                  uint64_t p0, uint64_t p1, uint64_t p2, uint64_t p3) {
+    uint64_t next = 0;
+    uint16_t counts = rule->birth | rule->survive;
+    for (int n = 0; counts; n++, counts >>= 1) {
+        if (!(counts & 1)) {
+            continue;
+        }
+        uint64_t eq = ((n & 1) ? p0 : ~p0) & ((n & 2) ? p1 : ~p1)
+                    & ((n & 4) ? p2 : ~p2) & ((n & 8) ? p3 : ~p3);
+        uint64_t who = (((rule->birth >> n) & 1) ? ~alive : 0)
+                     | (((rule->survive >> n) & 1) ? alive : 0);
+        next |= eq & who;
+    }
+    return next;
+}
+
+/*
+* What a step did, counted by the kernels on the words they have just computed.
+* The kernels only add births and deaths, engines keep the population from them.
+*/
+typedef struct StepStats {
+    long gen;
+    long pop;
+    long births;
+    long deaths;
+} StepStats;
+
+// x86 builds without popcnt get a popcnt copy of each kernel picked at load time, the
+// library popcount would otherwise cost more than the step itself on light rules
+#if defined(__x86_64__) && !defined(__POPCNT__)
+#define KERNEL_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define KERNEL_CLONES
+#endif
+
+/**
+* @brief counts the births and deaths of one word
+*/
+static inline void count_changes(long *births, long *deaths, uint64_t old, uint64_t next) {
+    *births += __builtin_popcountll(next & ~old);
+    *deaths += __builtin_popcountll(old & ~next);
+}
+
+// neighbors to the west and east of word w in a row, carrying across word edges
+#define ROW_WEST(r, w, words) (((r)[w] << 1) | ((w) > 0 ? (r)[(w)-1] >> 63 : 0))
+#define ROW_EAST(r, w, words) (((r)[w] >> 1) | ((w)+1 < (words) ? (r)[(w)+1] << 63 : 0))
+
+/**
+* @brief steps rows y0 to y1 of a board with the 8 cell Moore neighborhood
+* @param rule the rule to apply
+* @param src the current board
+* @param dst the board receiving the next generation
+* @param y0 the first row
+* @param y1 one past the last row
+* @param stats receives the births and deaths added up, NULL if not wanted
+*/
+KERNEL_CLONES void step_moore(const Rule *rule, const Board *src, Board *dst, int y0, int y1, StepStats *stats) {
+    int words = src->words;
+    uint64_t last = board_last_mask(src);
+    long births = 0, deaths = 0;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *a = board_row(src, y-1);
+        const uint64_t *c = board_row(src, y);
+        const uint64_t *b = board_row(src, y+1);
+        uint64_t *out = board_row(dst, y);
+        for (int w = 0; w < words; w++) {
+            uint64_t sa, ca, sb, cb, sm, cm, one, c1, t, c2, two, c3, four, eight;
+            FULL_ADD(sa, ca, ROW_WEST(a, w, words), a[w], ROW_EAST(a, w, words));
+            FULL_ADD(sb, cb, ROW_WEST(b, w, words), b[w], ROW_EAST(b, w, words));
+            HALF_ADD(sm, cm, ROW_WEST(c, w, words), ROW_EAST(c, w, words));
+            FULL_ADD(one, c1, sa, sb, sm);
+            FULL_ADD(t, c2, ca, cb, cm);
+            HALF_ADD(two, c3, t, c1);
+            HALF_ADD(four, eight, c2, c3);
+            uint64_t next = rule_apply(rule, c[w], one, two, four, eight);
+            if (stats) {  // predictable, so the stats cost nothing when not wanted
+                count_changes(&births, &deaths, c[w], (w == words-1) ? next & last : next);
+            }
+            out[w] = next;
+        }
+        out[words-1] &= last;
+    }
+    if (stats) {
+        stats->births += births;
+        stats->deaths += deaths;
+    }
+}
+
+/**
+* @brief steps rows y0 to y1 of a board with the 6 cell hexagonal neighborhood
+*
+* The hex lattice is stored sheared, the neighbors of (x,y) are the Moore neighbors
+* without the north east (x+1,y-1) and south west (x-1,y+1) corners.
+* @param rule the rule to apply
+* @param src the current board
+* @param dst the board receiving the next generation
+* @param y0 the first row
+* @param y1 one past the last row
+* @param stats receives the births and deaths added up, NULL if not wanted
+*/
+KERNEL_CLONES void step_hex(const Rule *rule, const Board *src, Board *dst, int y0, int y1, StepStats *stats) {
+    int words = src->words;
+    uint64_t last = board_last_mask(src);
+    long births = 0, deaths = 0;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *a = board_row(src, y-1);
+        const uint64_t *c = board_row(src, y);
+        const uint64_t *b = board_row(src, y+1);
+        uint64_t *out = board_row(dst, y);
+        for (int w = 0; w < words; w++) {
+            uint64_t s1, c1, s2, c2, one, c3, two, four;
+            FULL_ADD(s1, c1, ROW_WEST(a, w, words), a[w], ROW_WEST(c, w, words));
+            FULL_ADD(s2, c2, ROW_EAST(c, w, words), b[w], ROW_EAST(b, w, words));
+            HALF_ADD(one, c3, s1, s2);
+            FULL_ADD(two, four, c1, c2, c3);
+            uint64_t next = rule_apply(rule, c[w], one, two, four, 0);
+            if (stats) {
+                count_changes(&births, &deaths, c[w], (w == words-1) ? next & last : next);
+            }
+            out[w] = next;
+        }
+        out[words-1] &= last;
+    }
+    if (stats) {
+        stats->births += births;
+        stats->deaths += deaths;
+    }
+}
+
+/**
+* @brief steps rows y0 to y1 of a board with the 4 cell von Neumann neighborhood
+* @param rule the rule to apply
+* @param src the current board
+* @param dst the board receiving the next generation
+* @param y0 the first row
+* @param y1 one past the last row
+* @param stats receives the births and deaths added up, NULL if not wanted
+*/
+KERNEL_CLONES void step_vonneumann(const Rule *rule, const Board *src, Board *dst, int y0, int y1, StepStats *stats) {
+    int words = src->words;
+    uint64_t last = board_last_mask(src);
+    long births = 0, deaths = 0;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *a = board_row(src, y-1);
+        const uint64_t *c = board_row(src, y);
+        const uint64_t *b = board_row(src, y+1);
+        uint64_t *out = board_row(dst, y);
+        for (int w = 0; w < words; w++) {
+            uint64_t s1, c1, s2, c2, one, c3, two, four;
+            HALF_ADD(s1, c1, a[w], b[w]);
+            HALF_ADD(s2, c2, ROW_WEST(c, w, words), ROW_EAST(c, w, words));
+            HALF_ADD(one, c3, s1, s2);
+            FULL_ADD(two, four, c1, c2, c3);
+            uint64_t next = rule_apply(rule, c[w], one, two, four, 0);
+            if (stats) {
+                count_changes(&births, &deaths, c[w], (w == words-1) ? next & last : next);
+            }
+            out[w] = next;
+        }
+        out[words-1] &= last;
+    }
+    if (stats) {
+        stats->births += births;
+        stats->deaths += deaths;
+    }
+}
+
+/**
+* @brief steps rows y0 to y1 of a board with the kernel matching the rule's neighborhood
+* @param rule the rule to apply
+* @param src the current board
+* @param dst the board receiving the next generation
+* @param y0 the first row
+* @param y1 one past the last row
+* @param stats receives the births and deaths added up, NULL if not wanted
+*/
+void board_step_rows(const Rule *rule, const Board *src, Board *dst, int y0, int y1, StepStats *stats) {
+    switch (rule->neighborhood) {
+        case NEIGHBORHOOD_HEX:
+            step_hex(rule, src, dst, y0, y1, stats);
+            break;
+        case NEIGHBORHOOD_VN:
+            step_vonneumann(rule, src, dst, y0, y1, stats);
+            break;
+        default:
+            step_moore(rule, src, dst, y0, y1, stats);
+    }
+}
+
+/**
+* @brief steps a whole board with the kernel matching the rule's neighborhood
+* @param rule the rule to apply
+* @param src the current board
+* @param dst the board receiving the next generation
+*/
+void board_step(const Rule *rule, const Board *src, Board *dst) {
+    board_step_rows(rule, src, dst, 0, src->height, NULL);
+}
+
+/*
+* Chances applied on top of a rule: a birth or survival the rule allows happens
+* with the given chance, then every cell flips with the noise chance.
+*/
+typedef struct {
+    uint32_t birth;
+    uint32_t survive;
+    uint32_t noise;
+    uint64_t seed;
+} Chance;
+
+/**
+* @brief applies the chances to a freshly stepped row
+* @param chance the chances
+* @param old the row before the step
+* @param row the row after the step, updated in place
+* @param words the words in the row
+* @param last the mask of the last word
+* @param y the row number
+* @param gen the generation being produced
+*/
+void chance_row(const Chance *chance, const uint64_t *old, uint64_t *row, int words,
+                uint64_t last, int y, long gen) {
+    for (int w = 0; w < words; w++) {
+        // draws are numbered apart so births, survivals and noise never share bits
+        uint32_t ctr[4] = { (uint32_t) w, (uint32_t) y, (uint32_t) gen, 0 };
+        uint64_t born = row[w] & ~old[w];
+        uint64_t kept = row[w] & old[w];
+        uint64_t next = born & random_mask(chance->birth, chance->seed, ctr);
+        ctr[3] = 0x100;
+        next |= kept & random_mask(chance->survive, chance->seed, ctr);
+        ctr[3] = 0x200;
+        next ^= random_mask(chance->noise, chance->seed, ctr);
+        row[w] = next;
+    }
+    row[words-1] &= last;
+}
+
+/**
+* @brief checks whether the chances change anything
+*/
+bool chance_active(const Chance *chance) {
+    return chance->birth < CHANCE_ONE || chance->survive < CHANCE_ONE || chance->noise > 0;
+}
+
+/**
+* @brief hashes one word of a board, Zobrist style
+*
+* Each (position, value) pair maps to its own random looking key and a board hashes
+* to the XOR of the keys of its words, so a step only has to touch the words that
+* changed. Empty words hash to 0 and cost nothing.
+* @param w the word in the row
+* @param y the row
+* @param value the word
+* @return the key of the word
+*/
+static inline uint64_t word_hash(int w, int y, uint64_t value) {
+    if (!value) {
+        return 0;
+    }
+    uint64_t h = value ^ ((((uint64_t) y << 32) | (uint32_t) w) * 0x9E3779B97F4A7C15ULL);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return (h ^ (h >> 31)) | 1;
+}
+
+/**
+* @brief hashes rows y0 to y1-1 of a board and counts their live cells
+* @param pop receives the live cells, NULL if not wanted
+* @return the XOR of the keys of their words
+*/
+uint64_t board_rows_hash(const Board *b, int y0, int y1, long *pop) {
+    uint64_t h = 0;
+    long n = 0;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *row = board_row(b, y);
+        for (int w = 0; w < b->words; w++) {
+            h ^= word_hash(w, y, row[w]);
+            if (pop) {
+                n += __builtin_popcountll(row[w]);
+            }
+        }
+    }
+    if (pop) {
+        *pop = n;
+    }
+    return h;
+}
+
+/**
+* @brief hashes a whole board, used to start the incremental hash
+* @param b a pointer to the board
+* @return the XOR of the keys of every word
+*/
+uint64_t board_hash(const Board *b) {
+    return board_rows_hash(b, 0, b->height, NULL);
+}
+
+/*
+* Edits of a running board: setting a cell, filling a rectangle or pasting a pattern,
+* and the clipboard operations, which go through the same rings so a copy sees the
+* board of the generation it is queued for.
+* Producers such as an edit script or the TUI keys each own a single producer, single
+* consumer ring, and the step loop applies the edits that are due between two
+* generations. The rings only move their two indices with acquire and release, so the
+* step loop never waits: a full ring holds up its producer, never the simulation.
+*/
+#define EDIT_QUEUE   256  // edits per ring, a power of two
+#define EDIT_SET     0
+#define EDIT_FILL    1
+#define EDIT_PASTE   2
+#define EDIT_COPY    3  // the rectangle into the clipboard
+#define EDIT_ORIENT  4  // turns or mirrors the clipboard
+#define EDIT_CLIP    5  // pastes the clipboard with its top left at x, y
+
+typedef struct Edit {
+    int op;
+    long gen;           // applied before generation gen is stepped, or as soon as possible after
+    int x, y, w, h;     // the cell, or the rectangle filled or pasted into
+    bool value;         // for set and fill
+    int mode;           // the orientation of the clipboard, or its PASTE_ mode
+    uint64_t on[64];    // paste: live cells, bit x of on[y]
+    uint64_t mask[64];  // paste: cells written, the others stay as they are
+} Edit;
+
+typedef struct {
+    Edit edits[EDIT_QUEUE];
+    atomic_long head;  // next edit to apply, only moved by the consumer
+    atomic_long tail;  // next free slot, only moved by the producer
+} EditQueue;
+
+/**
+* @brief queues an edit, called by the producer only
+* @return false if the ring was full
+*/
+bool edit_push(EditQueue *q, const Edit *e) {
+    long tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&q->head, memory_order_acquire) == EDIT_QUEUE) {
+        return false;
+    }
+    q->edits[tail & (EDIT_QUEUE - 1)] = *e;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/**
+* @brief looks at the oldest edit, called by the consumer only
+* @return the edit, NULL if the ring is empty
+*/
+const Edit *edit_peek(EditQueue *q) {
+    long head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&q->tail, memory_order_acquire)) {
+        return NULL;
+    }
+    return &q->edits[head & (EDIT_QUEUE - 1)];
+}
+
+/**
+* @brief drops the oldest edit once applied, called by the consumer only
+*/
+void edit_pop(EditQueue *q) {
+    long head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+}
+
+/**
+* @brief gets the rows an edit can change, clipped to the board
+* @return false if it changes none
+*/
+bool edit_rows(const Board *b, const Edit *e, int *y0, int *y1) {
+    if (e->op == EDIT_COPY || e->op == EDIT_ORIENT || (e->op == EDIT_CLIP && !clipboard.data)) {
+        return false;
+    }
+    int h = (e->op == EDIT_SET) ? 1 : (e->op == EDIT_CLIP) ? clipboard.height : e->h;
+    *y0 = (e->y > 0) ? e->y : 0;
+    *y1 = (e->y + h < b->height) ? e->y + h : b->height;
+    return *y1 > *y0;
+}
+
+/**
+* @brief applies an edit to a board, cells outside the board are ignored
+*/
+void board_edit(Board *b, const Edit *e) {
+    if (e->op == EDIT_SET) {
+        board_set(b, e->x, e->y, e->value);
+    } else if (e->op == EDIT_FILL) {
+        int x0 = (e->x > 0) ? e->x : 0;
+        int x1 = (e->x + e->w < b->width) ? e->x + e->w : b->width;
+        int y0, y1;
+        if (x1 <= x0 || !edit_rows(b, e, &y0, &y1)) {
+            return;
+        }
+        for (int y = y0; y < y1; y++) {
+            uint64_t *row = board_row(b, y);
+            for (int w = x0 >> 6; w <= (x1 - 1) >> 6; w++) {
+                int lo = (x0 > w*64) ? x0 - (w*64) : 0;
+                int hi = (x1 < (w+1)*64) ? x1 - (w*64) : 64;
+                uint64_t m = ((hi == 64) ? ~0ULL : (1ULL << hi) - 1) & ~((1ULL << lo) - 1);
+                row[w] = e->value ? row[w] | m : row[w] & ~m;
+            }
+        }
+    } else if (e->op == EDIT_PASTE) {
+        for (int y = 0; y < e->h; y++) {
+            for (int x = 0; x < e->w; x++) {
+                if ((e->mask[y] >> x) & 1) {
+                    board_set(b, e->x + x, e->y + y, (e->on[y] >> x) & 1);
+                }
+            }
+        }
+    } else if (e->op == EDIT_COPY) {
+        board_destroy(&clipboard);
+        if (e->w > 0 && e->h > 0) {
+            board_copy_region(b, e->x, e->y, e->w, e->h, &clipboard);
+        }
+    } else if (e->op == EDIT_ORIENT && clipboard.data) {
+        board_orient(&clipboard, e->mode);
+    } else if (e->op == EDIT_CLIP && clipboard.data) {
+        board_paste(b, &clipboard, e->x, e->y, e->mode);
+    }
+}
+
+/*
+* The bit packed engine, two boards are stepped into each other by pointer swap.
+* Extra arguments after the rule set chances: pb=0.9 ps=0.95 noise=0.001 seed=1.
+* Large boards are stepped in bands of rows across threads.
+*
+* Deterministic runs keep an incremental hash of each generation in a ring of the
+* last CYCLE_RING generations. Once a hash repeats, and stepping a copy of the board
+* over the period brings it back, the period is known: headless runs jump over whole
+* cycles and the TUI records one cycle of boards and replays it.
+*/
+#define CYCLE_RING   64
+#define CYCLE_MEMORY (256L << 20)  // bytes the TUI may spend on a recorded cycle
+
+Rule bits_rule;
+Chance bits_chance;
+Board bits_boards[2];
+Board *bits_cur = &bits_boards[0];
+Board *bits_next = &bits_boards[1];
+long bits_gen;
+
+uint64_t bits_hash;                   // hash of bits_cur
+uint64_t cycle_hashes[CYCLE_RING];    // hash of generation g is kept at g % CYCLE_RING
+long bits_period;                     // 0 until a repeat is seen
+long bits_cycle_gen;                  // the generation the repeat was seen at
+long bits_edit_gen;                   // the last edit, repeats are only looked for after it
+Board *cycle_boards;                  // one recorded cycle, NULL if not recording
+int cycle_recorded;
+StepStats bits_stats;                 // of the step into bits_cur
+StepStats cycle_stats[CYCLE_RING];    // of the step into each recorded board
+
+/**
+* @brief parses the chance arguments of the bit packed engine
+* @param argc the argument count
+* @param argv the arguments, each in name=value form
+* @param chance where to store the chances
+* @return true if every argument was understood
+*/
+bool parse_chance(int argc, char **argv, Chance *chance) {
+    chance->birth = CHANCE_ONE;
+    chance->survive = CHANCE_ONE;
+    chance->noise = 0;
+    chance->seed = 0;
+    for (int i = 0; i < argc; i++) {
+        char name[16];
+        double value;
+        if (sscanf(argv[i], "%15[^=]=%lf", name, &value) != 2) {
+            fprintf(stderr, "[E] Invalid argument: %s\n", argv[i]);
+            return false;
+        }
+        if (strcmp(name, "pb") == 0) {
+            chance->birth = chance_from(value);
+        } else if (strcmp(name, "ps") == 0) {
+            chance->survive = chance_from(value);
+        } else if (strcmp(name, "noise") == 0) {
+            chance->noise = chance_from(value);
+        } else if (strcmp(name, "seed") == 0) {
+            chance->seed = (uint64_t) value;
+        } else {
+            fprintf(stderr, "[E] Unknown argument: %s\n", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief sets up the bit packed engine and seeds it with a random soup
+* @return true if the rule was valid and memory was allocated
+*/
+bool bits_init(int argc, char **argv) {
+    if (!parse_rule((argc > 0) ? argv[0] : "B3/S23", &bits_rule)) {
+        return false;
+    }
+    if (!parse_chance((argc > 1) ? argc-1 : 0, argv+1, &bits_chance)) {
+        return false;
+    }
+    if (!board_init(&bits_boards[0], board_width, board_height)
+        || !board_init(&bits_boards[1], board_width, board_height)) {
+        return false;
+    }
+    bits_gen = 0;
+    bits_period = 0;
+    cycle_boards = NULL;
+    cycle_recorded = 0;
+    if (!soup_fill(bits_cur, &soup, 0, 0, board_width, board_height)) {
+        return false;
+    }
+    bits_stats = (StepStats) { 0, 0, 0, 0 };
+    bits_hash = board_rows_hash(bits_cur, 0, bits_cur->height, &bits_stats.pop);
+    cycle_hashes[0] = bits_hash;
+    bits_edit_gen = 0;
+    return true;
+}
+
+typedef struct {
+    int rows;           // rows per band
+    uint64_t *delta;    // hash change of each band
+    StepStats *stats;   // births and deaths of each band
+} BitsJob;
+
+/**
+* @brief steps one band of rows, applying the chances row by row while they are in cache
+*/
+void bits_task(int task, void *arg) {
+    BitsJob *job = (BitsJob*) arg;
+    int y0 = task * job->rows;
+    int y1 = (y0 + job->rows < bits_cur->height) ? y0 + job->rows : bits_cur->height;
+    bool chance = chance_active(&bits_chance);
+    uint64_t last = board_last_mask(bits_cur);
+    uint64_t delta = 0;
+    StepStats stats = { 0 };
+    board_step_rows(&bits_rule, bits_cur, bits_next, y0, y1, chance ? NULL : &stats);
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *old = board_row(bits_cur, y);
+        uint64_t *row = board_row(bits_next, y);
+        if (chance) {
+            // the chances change the row after the kernel, so it is counted afterwards
+            chance_row(&bits_chance, old, row, bits_cur->words, last, y, bits_gen+1);
+            for (int w = 0; w < bits_cur->words; w++) {
+                count_changes(&stats.births, &stats.deaths, old[w], row[w]);
+            }
+            continue;  // stochastic runs never repeat for sure, so they are not hashed
+        }
+        for (int w = 0; w < bits_cur->words; w++) {
+            if (row[w] != old[w]) {
+                delta ^= word_hash(w, y, old[w]) ^ word_hash(w, y, row[w]);
+            }
+        }
+    }
+    job->delta[task] = delta;
+    job->stats[task] = stats;
+}
+
+/**
+* @brief checks that the board comes back after period steps, so that a matching
+* hash is a real repeat and not a collision
+* @return false if it does not, or if memory ran out
+*/
+bool bits_confirm_period(long period) {
+    Board a, b;
+    if (!board_init(&a, bits_cur->width, bits_cur->height)) {
+        return false;
+    }
+    if (!board_init(&b, bits_cur->width, bits_cur->height)) {
+        board_destroy(&a);
+        return false;
+    }
+    size_t bytes = (size_t) (bits_cur->height + 2) * bits_cur->words * sizeof(uint64_t);
+    memcpy(a.data, bits_cur->data, bytes);
+    for (long i = 0; i < period; i++) {
+        board_step(&bits_rule, &a, &b);
+        Board t = a;
+        a = b;
+        b = t;
+    }
+    bool same = memcmp(a.data, bits_cur->data, bytes) == 0;
+    board_destroy(&a);
+    board_destroy(&b);
+    return same;
+}
+
+/**
+* @brief records the hash of the new generation and looks for it in the ring
+*/
+void bits_track_cycle() {
+    if (bits_period == 0) {
+        long oldest = (bits_gen > CYCLE_RING) ? bits_gen - CYCLE_RING : 0;
+        oldest = (oldest > bits_edit_gen) ? oldest : bits_edit_gen;
+        for (long g = bits_gen - 1; g >= oldest; g--) {
+            if (cycle_hashes[g % CYCLE_RING] == bits_hash && bits_confirm_period(bits_gen - g)) {
+                bits_period = bits_gen - g;
+                bits_cycle_gen = bits_gen;
+                break;
+            }
+        }
+    }
+    cycle_hashes[bits_gen % CYCLE_RING] = bits_hash;
+}
+
+/**
+* @brief frees a recorded cycle
+*/
+void bits_free_cycle() {
+    if (cycle_boards) {
+        for (int i = 0; i < cycle_recorded; i++) {
+            board_destroy(&cycle_boards[i]);
+        }
+        free(cycle_boards);
+        cycle_boards = NULL;
+    }
+}
+
+/**
+* @brief records the current board as the next board of the cycle
+*
+* Cycles that do not fit in CYCLE_MEMORY are not recorded and keep being computed.
+*/
+void bits_record_cycle() {
+    size_t bytes = (size_t) (bits_cur->height + 2) * bits_cur->words * sizeof(uint64_t);
+    if (!cycle_boards) {
+        if (bytes * bits_period > CYCLE_MEMORY
+            || !(cycle_boards = (Board*) calloc(bits_period, sizeof(Board)))) {
+            cycle_recorded = -1;
+            return;
+        }
+    }
+    Board *b = &cycle_boards[cycle_recorded];
+    if (!board_init(b, bits_cur->width, bits_cur->height)) {
+        bits_free_cycle();
+        cycle_recorded = -1;
+        return;
+    }
+    memcpy(b->data, bits_cur->data, bytes);
+    cycle_stats[cycle_recorded] = bits_stats;
+    cycle_recorded++;
+}
+
+/**
+* @brief advances the bit packed board by one generation
+*/
+void bits_step() {
+    // a recorded cycle is replayed without stepping
+    if (bits_period > 0 && cycle_recorded == bits_period) {
+        bits_gen++;
+        bits_cur = &cycle_boards[(bits_gen - bits_cycle_gen) % bits_period];
+        bits_stats = cycle_stats[(bits_gen - bits_cycle_gen) % bits_period];
+        bits_stats.gen = bits_gen;
+        return;
+    }
+
+    // bands of at least 4096 words so small boards stay on one thread
+    int height = bits_cur->height;
+    int bands = (int) (((long) height * bits_cur->words) / 4096);
+    bands = (bands < 1) ? 1 : (bands > thread_count * 4) ? thread_count * 4 : bands;
+    uint64_t delta[MAX_THREADS * 4];
+    StepStats stats[MAX_THREADS * 4];
+    BitsJob job = { (height + bands - 1) / bands, delta, stats };
+    int tasks = (height + job.rows - 1) / job.rows;
+    run_parallel(tasks, bits_task, &job);
+
+    Board *t = bits_cur;
+    bits_cur = bits_next;
+    bits_next = t;
+    bits_gen++;
+    bits_stats.gen = bits_gen;
+    bits_stats.births = 0;
+    bits_stats.deaths = 0;
+    for (int i = 0; i < tasks; i++) {
+        bits_stats.births += stats[i].births;
+        bits_stats.deaths += stats[i].deaths;
+    }
+    bits_stats.pop += bits_stats.births - bits_stats.deaths;
+
+    if (chance_active(&bits_chance)) {
+        return;
+    }
+    for (int i = 0; i < tasks; i++) {
+        bits_hash ^= delta[i];
+    }
+    bits_track_cycle();
+}
+
+/**
+* @brief jumps over whole cycles once the period is known, used by headless runs
+* @param gens the generations still to run
+* @return the generations skipped
+*/
+long bits_skip(long gens) {
+    if (bits_period == 0) {
+        return 0;
+    }
+    long skipped = gens - (gens % bits_period);
+    bits_gen += skipped;
+    bits_stats.gen = bits_gen;  // whole cycles later the step is the same one
+    return skipped;
+}
+
+/**
+* @brief prints the period found by a headless run
+*/
+void bits_report() {
+    if (bits_period > 0) {
+        printf("period %ld, first repeat at generation %ld\n", bits_period, bits_cycle_gen);
+    } else if (chance_active(&bits_chance)) {
+        printf("stochastic rule, no cycle detection\n");
+    } else {
+        printf("no cycle of period up to %d found\n", CYCLE_RING);
+    }
+}
+
+/**
+* @brief floor division, used to map screen pixels onto the sheared hex lattice
+*/
+int floor_div(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+* @brief copies the centre of a board onto the screen
+*
+* Hexagonal boards are un-sheared: every cell is drawn 2 pixels wide and each row is
+* shifted half a cell from the one above, so the sextant glyphs show an offset lattice.
+* @param b the board to draw
+* @param neighborhood the neighborhood the board is stepped with
+* @param scr a pointer to the current screen
+*/
+void board_draw(const Board *b, char neighborhood, Screen *scr) {
+    int xc = b->width / 2;
+    int yc = b->height / 2;
+    for (int y = 0; y < scr->height; y++) {
+        int by = yc - (scr->height / 2) + y;
+        for (int x = 0; x < scr->width; x++) {
+            int bx;
+            if (neighborhood == NEIGHBORHOOD_HEX) {
+                bx = xc + floor_div(x - (scr->width / 2) + (by - yc), 2);
+            } else {
+                bx = xc - (scr->width / 2) + x;
+            }
+            setScreenPixel(scr, x,y, board_get(b, bx, by));
+        }
+    }
+}
+
+void bits_draw(Screen *scr) {
+    // the TUI records the first cycle it sees and replays it from then on
+    if (bits_period > 0 && cycle_recorded >= 0 && cycle_recorded < bits_period) {
+        bits_record_cycle();
+    }
+    board_draw(bits_cur, bits_rule.neighborhood, scr);
+}
+
+/**
+* @brief applies an edit between generations, the hash and population are updated
+* from the rows it touched and cycle detection starts over
+*/
+void bits_edit(const Edit *e) {
+    int y0, y1;
+    if (!edit_rows(bits_cur, e, &y0, &y1)) {
+        board_edit(bits_cur, e);  // clipboard only, the board stays as it is
+        return;
+    }
+    if (bits_cur != &bits_boards[0] && bits_cur != &bits_boards[1]) {
+        // replaying a recorded cycle, the edit goes to a copy of the board shown
+        size_t bytes = (size_t) (bits_cur->height + 2) * bits_cur->words * sizeof(uint64_t);
+        memcpy(bits_boards[0].data, bits_cur->data, bytes);
+        bits_cur = &bits_boards[0];
+        bits_next = &bits_boards[1];
+    }
+    bits_free_cycle();
+    cycle_recorded = 0;
+    bits_period = 0;
+    bits_edit_gen = bits_gen;
+
+    long before, after;
+    bits_hash ^= board_rows_hash(bits_cur, y0, y1, &before);
+    board_edit(bits_cur, e);
+    bits_hash ^= board_rows_hash(bits_cur, y0, y1, &after);
+    bits_stats.pop += after - before;
+    cycle_hashes[bits_gen % CYCLE_RING] = bits_hash;
+}
+
+const StepStats *bits_get_stats() {
+    return &bits_stats;
+}
+
+const Board *bits_board(const Rule **rule) {
+    *rule = &bits_rule;
+    return bits_cur;
+}
+
+void bits_destroy() {
+    board_destroy(&bits_boards[0]);
+    board_destroy(&bits_boards[1]);
+    board_destroy(&clipboard);
+    bits_free_cycle();
+}
+
+/*
+* Larger than Life rules, written in the usual R5,C0,M1,S34..58,B34..45,NM form.
+* R is the range, C the number of states (0 or 2 for plain two state rules, more
+* for decaying states), M whether the middle cell counts towards its own sum,
+* S and B the survival and birth ranges and N the neighborhood shape
+* (M for Moore, N for von Neumann).
+*/
+#define LTL_MAX_RANGE 50
+
+typedef struct {
+    int range;
+    int states;
+    bool middle;
+    int smin, smax;
+    int bmin, bmax;
+    char shape;
+} LtlRule;
+
+LtlRule ltl_rule;
+uint8_t *ltl_cells = NULL;  // cell states, board_width * board_height
+int32_t *ltl_sums = NULL;   // neighborhood sums for every cell
+int32_t *ltl_table = NULL;  // padded prefix table(s) used to build ltl_sums
+int32_t *ltl_table2 = NULL;
+int ltl_pad;                // padding around the board in the prefix tables
+int ltl_pwidth;             // padded width
+int ltl_pheight;            // padded height
+
+/**
+* @brief parses a number range in the form A..B
+* @param str the text following the S or B
+* @param min where to store the lower bound
+* @param max where to store the upper bound
+* @return true if the range was valid
+*/
+bool parse_ltl_range(const char *str, int *min, int *max) {
+    char *end;
+    *min = (int) strtol(str, &end, 10);
+    if (end == str) {
+        return false;
+    }
+    if (strncmp(end, "..", 2) == 0) {
+        str = end + 2;
+        *max = (int) strtol(str, &end, 10);
+        if (end == str) {
+            return false;
+        }
+    } else {
+        *max = *min;
+    }
+    return *min <= *max;
+}
+
+/**
+* @brief parses a Larger than Life rule string
+* @param str the rule, for example R5,C0,M1,S34..58,B34..45,NM
+* @param rule where to store the parsed rule
+* @return true if the rule was valid
+*/
+bool parse_ltl_rule(const char *str, LtlRule *rule) {
+    LtlRule r = { 1, 2, false, 2, 3, 3, 3, 'M' };
+    char buf[128];
+    if (strlen(str) >= sizeof(buf)) {
+        fprintf(stderr, "[E] Rule string too long!\n");
+        return false;
+    }
+    strcpy(buf, str);
+
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        bool ok = true;
+        switch (tok[0]) {
+            case 'R': case 'r':
+                r.range = atoi(tok+1);
+                ok = r.range >= 1 && r.range <= LTL_MAX_RANGE;
+                break;
+            case 'C': case 'c':
+                r.states = atoi(tok+1);
+                if (r.states < 2) {
+                    r.states = 2;
+                }
+                ok = r.states <= 255;
+                break;
+            case 'M': case 'm':
+                r.middle = atoi(tok+1) != 0;
+                break;
+            case 'S': case 's':
+                ok = parse_ltl_range(tok+1, &r.smin, &r.smax);
+                break;
+            case 'B': case 'b':
+                ok = parse_ltl_range(tok+1, &r.bmin, &r.bmax);
+                break;
+            case 'N': case 'n':
+                r.shape = tok[1];
+                ok = r.shape == 'M' || r.shape == 'N';
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "[E] Invalid rule component: %s\n", tok);
+            return false;
+        }
+    }
+    *rule = r;
+    return true;
+}
+
+/**
+* @brief checks if a board cell is alive, cells outside the board are dead
+* @param x the x position of the cell
+* @param y the y position of the cell
+* @return 1 if the cell is alive, 0 otherwise
+*/
+int32_t ltl_alive(int x, int y) {
+    if (x < 0 || x >= board_width || y < 0 || y >= board_height) {
+        return 0;
+    }
+    return ltl_cells[(y*board_width)+x] == 1;
+}
+
+/**
+* @brief fills ltl_sums using a summed area table, the cost per cell does not depend on the range
+*/
+void ltl_sum_moore() {
+    int r = ltl_rule.range;
+    int p = ltl_pad;
+    int tw = ltl_pwidth + 1; // the table has an extra leading row and column of zeros
+
+    // S[j][i] holds the live cells in padded rows < j and padded columns < i
+    for (int j = 1; j <= ltl_pheight; j++) {
+        int32_t row = 0;
+        for (int i = 1; i <= ltl_pwidth; i++) {
+            row += ltl_alive(i-1-p, j-1-p);
+            ltl_table[(j*tw)+i] = ltl_table[((j-1)*tw)+i] + row;
+        }
+    }
+
+    // the box for board cell (x,y) covers padded cells x+p-r .. x+p+r
+    int d = (2*r)+1;
+    for (int y = 0; y < board_height; y++) {
+        int32_t *top = &ltl_table[(y+p-r)*tw];
+        int32_t *bottom = &ltl_table[(y+p-r+d)*tw];
+        for (int x = 0; x < board_width; x++) {
+            int i = x+p-r;
+            ltl_sums[(y*board_width)+x] = bottom[i+d] - bottom[i] - top[i+d] + top[i];
+        }
+    }
+}
+
+/**
+* @brief fills ltl_sums for the von Neumann diamond by sliding it along each row
+*
+* Moving the diamond one cell right adds its new right edge and drops its old left edge,
+* both edges are two diagonal segments which are read from running diagonal sums,
+* so the cost per cell is constant. Each row starts with the diamond fully outside the
+* board where the sum is known to be zero.
+*/
+void ltl_sum_vonneumann() {
+    int r = ltl_rule.range;
+    int p = ltl_pad;
+    int pw = ltl_pwidth;
+    int32_t *da = ltl_table;   // running sums down the i-j diagonals
+    int32_t *ad = ltl_table2;  // running sums down the i+j diagonals
+
+    for (int j = 0; j < ltl_pheight; j++) {
+        for (int i = 0; i < pw; i++) {
+            int32_t c = ltl_alive(i-p, j-p);
+            da[(j*pw)+i] = c + ((j > 0 && i > 0) ? da[((j-1)*pw)+i-1] : 0);
+            ad[(j*pw)+i] = c + ((j > 0 && i < pw-1) ? ad[((j-1)*pw)+i+1] : 0);
+        }
+    }
+
+    // segment sums in padded coordinates, j0 to j1 inclusive
+    #define LTL_DA(c, j0, j1) (da[((j1)*pw)+(j1)+(c)] - da[(((j0)-1)*pw)+(j0)-1+(c)])
+    #define LTL_AD(c, j0, j1) (ad[((j1)*pw)+(c)-(j1)] - ad[(((j0)-1)*pw)+(c)-(j0)+1])
+
+    for (int y = 0; y < board_height; y++) {
+        int py = y + p;
+        int32_t sum = 0;
+        for (int x = -r-1; x < board_width-1; x++) {
+            int px = x + p;
+            // right edge of the diamond centered on x+1, its middle cell is in both segments
+            int32_t add = LTL_DA(px+1+r-py, py-r, py) + LTL_AD(px+1+r+py, py, py+r)
+                        - ltl_alive(x+1+r, y);
+            // left edge of the diamond centered on x
+            int32_t drop = LTL_AD(px-r+py, py-r, py) + LTL_DA(px-r-py, py, py+r)
+                         - ltl_alive(x-r, y);
+            sum += add - drop;
+            if (x+1 >= 0) {
+                ltl_sums[(y*board_width)+x+1] = sum;
+            }
+        }
+    }
+    #undef LTL_DA
+    #undef LTL_AD
+}
+
+/**
+* @brief sets up the Larger than Life engine and seeds it with a random soup
+* @return true if the rule was valid and memory was allocated
+*/
+bool ltl_init(int argc, char **argv) {
+    const char *rule = (argc > 0) ? argv[0] : "R5,C0,M1,S34..58,B34..45,NM";
+    if (!parse_ltl_rule(rule, &ltl_rule)) {
+        return false;
+    }
+
+    // enough padding for the vN diamond to start a row fully outside the board
+    ltl_pad = (2*ltl_rule.range)+3;
+    ltl_pwidth = board_width + (2*ltl_pad);
+    ltl_pheight = board_height + (2*ltl_pad);
+
+    ltl_cells = (uint8_t*) calloc(board_width * board_height, sizeof(uint8_t));
+    ltl_sums = (int32_t*) calloc(board_width * board_height, sizeof(int32_t));
+    ltl_table = (int32_t*) calloc((ltl_pwidth+1) * (ltl_pheight+1), sizeof(int32_t));
+    ltl_table2 = (int32_t*) calloc((ltl_pwidth+1) * (ltl_pheight+1), sizeof(int32_t));
+    if (!ltl_cells || !ltl_sums || !ltl_table || !ltl_table2) {
+        fprintf(stderr, "Error allocating memory for the LtL board\n");
+        return false;
+    }
+
+    Board b;
+    if (!board_init(&b, board_width, board_height)) {
+        return false;
+    }
+    bool ok = soup_fill(&b, &soup, 0, 0, board_width, board_height);
+    for (int y = 0; y < board_height; y++) {
+        for (int x = 0; x < board_width; x++) {
+            ltl_cells[(y*board_width)+x] = board_get(&b, x, y);
+        }
+    }
+    board_destroy(&b);
+    return ok;
+}
+
+/**
+* @brief advances the Larger than Life board by one generation
+*/
+void ltl_step() {
+    if (ltl_rule.shape == 'N') {
+        ltl_sum_vonneumann();
+    } else {
+        ltl_sum_moore();
+    }
+
+    for (int i = 0; i < board_width * board_height; i++) {
+        uint8_t state = ltl_cells[i];
+        int32_t n = ltl_sums[i];
+        if (state == 1 && !ltl_rule.middle) {
+            n--;
+        }
+        if (state == 0) {
+            state = (n >= ltl_rule.bmin && n <= ltl_rule.bmax);
+        } else if (state == 1) {
+            if (n < ltl_rule.smin || n > ltl_rule.smax) {
+                state = (ltl_rule.states > 2) ? 2 : 0;
+            }
+        } else {
+            // decaying cells count down to death
+            state = (state+1 < ltl_rule.states) ? state+1 : 0;
+        }
+        ltl_cells[i] = state;
+    }
+}
+
+/**
+* @brief copies the centre of the LtL board onto the screen
+* @param scr a pointer to the current screen
+*/
+void ltl_draw(Screen *scr) {
+    int x0 = (board_width - scr->width) / 2;
+    int y0 = (board_height - scr->height) / 2;
+    for (int y = 0; y < scr->height; y++) {
+        for (int x = 0; x < scr->width; x++) {
+            int bx = x0 + x;
+            int by = y0 + y;
+            bool on = bx >= 0 && bx < board_width && by >= 0 && by < board_height
+                   && ltl_cells[(by*board_width)+bx] == 1;
+            setScreenPixel(scr, x,y, on);
+        }
+    }
+}
+
+void ltl_destroy() {
+    free(ltl_cells);
+    free(ltl_sums);
+    free(ltl_table);
+    free(ltl_table2);
+    ltl_cells = NULL;
+    ltl_sums = NULL;
+    ltl_table = NULL;
+    ltl_table2 = NULL;
+}
+
+/*
+* Complex number type for the in-tree FFT
+*/
+typedef struct {
+    float re;
+    float im;
+} Complex;
+
+/**
+* @brief in place iterative radix-2 FFT
+* @param a the data, n entries
+* @param n the length, a power of two
+* @param inverse true for the inverse transform (unscaled)
+*/
+void fft(Complex *a, int n, bool inverse) {
+    // bit reversal permutation
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            Complex t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        double ang = 2 * M_PI / len * (inverse ? 1 : -1);
+        Complex wl = { (float) cos(ang), (float) sin(ang) };
+        for (int i = 0; i < n; i += len) {
+            Complex w = { 1, 0 };
+            for (int k = 0; k < len/2; k++) {
+                Complex u = a[i+k];
+                Complex v = a[i+k+(len/2)];
+                Complex t = { (v.re*w.re) - (v.im*w.im), (v.re*w.im) + (v.im*w.re) };
+                a[i+k].re = u.re + t.re;
+                a[i+k].im = u.im + t.im;
+                a[i+k+(len/2)].re = u.re - t.re;
+                a[i+k+(len/2)].im = u.im - t.im;
+                float wr = (w.re*wl.re) - (w.im*wl.im);
+                w.im = (w.re*wl.im) + (w.im*wl.re);
+                w.re = wr;
+            }
+        }
+    }
+}
+
+/**
+* @brief 2D real to complex FFT, two real rows are transformed at once as one complex row
+* @param in the real input, width * height
+* @param out the half spectrum, height * (width/2+1)
+* @param width the width, a power of two
+* @param height the height, a power of two of at least 2
+* @param tmp scratch space of max(width, height) entries
+*/
+void rfft2d(const float *in, Complex *out, int width, int height, Complex *tmp) {
+    int hw = (width/2)+1;
+    for (int y = 0; y < height; y += 2) {
+        for (int x = 0; x < width; x++) {
+            tmp[x].re = in[(y*width)+x];
+            tmp[x].im = in[((y+1)*width)+x];
+        }
+        fft(tmp, width, false);
+        // split the spectra using the conjugate symmetry of real signals
+        for (int k = 0; k < hw; k++) {
+            Complex z = tmp[k];
+            Complex zc = tmp[(width-k) & (width-1)];
+            out[(y*hw)+k].re = (z.re + zc.re) / 2;
+            out[(y*hw)+k].im = (z.im - zc.im) / 2;
+            out[((y+1)*hw)+k].re = (z.im + zc.im) / 2;
+            out[((y+1)*hw)+k].im = (zc.re - z.re) / 2;
+        }
+    }
+    for (int x = 0; x < hw; x++) {
+        for (int y = 0; y < height; y++) {
+            tmp[y] = out[(y*hw)+x];
+        }
+        fft(tmp, height, false);
+        for (int y = 0; y < height; y++) {
+            out[(y*hw)+x] = tmp[y];
+        }
+    }
+}
+
+/**
+* @brief 2D complex to real inverse FFT of a half spectrum, scaled so it inverts rfft2d
+* @param in the half spectrum, height * (width/2+1), it is overwritten
+* @param out the real output, width * height
+* @param width the width, a power of two
+* @param height the height, a power of two of at least 2
+* @param tmp scratch space of max(width, height) entries
+*/
+void irfft2d(Complex *in, float *out, int width, int height, Complex *tmp) {
+    int hw = (width/2)+1;
+    for (int x = 0; x < hw; x++) {
+        for (int y = 0; y < height; y++) {
+            tmp[y] = in[(y*hw)+x];
+        }
+        fft(tmp, height, true);
+        for (int y = 0; y < height; y++) {
+            in[(y*hw)+x] = tmp[y];
+        }
+    }
+    float scale = 1.0f / ((float) width * height);
+    for (int y = 0; y < height; y += 2) {
+        // rebuild the full spectrum of row y + i * row y+1
+        for (int k = 0; k < width; k++) {
+            Complex a, b;
+            if (k < hw) {
+                a = in[(y*hw)+k];
+                b = in[((y+1)*hw)+k];
+            } else {
+                a = in[(y*hw)+width-k];
+                b = in[((y+1)*hw)+width-k];
+                a.im = -a.im;
+                b.im = -b.im;
+            }
+            tmp[k].re = a.re - b.im;
+            tmp[k].im = a.im + b.re;
+        }
+        fft(tmp, width, true);
+        for (int x = 0; x < width; x++) {
+            out[(y*width)+x] = tmp[x].re * scale;
+            out[((y+1)*width)+x] = tmp[x].im * scale;
+        }
+    }
+}
+
+/*
+* Lenia, a continuous state engine written as R13,m0.15,s0.017,T10,D1. R is the kernel
+* radius, m and s the centre and width of the growth function, T the number of steps per
+* unit of time and D whether the screen is dithered (1) or thresholded at one half (0).
+* The world is a torus with power of two sides so the convolution runs through the FFT.
+*/
+typedef struct {
+    int radius;
+    float mu;
+    float sigma;
+    float dt;
+    bool dither;
+} LeniaParams;
+
+LeniaParams lenia;
+int lenia_width;
+int lenia_height;
+float *lenia_cells = NULL;       // cell values in [0,1]
+float *lenia_potential = NULL;   // the cells convolved with the kernel
+Complex *lenia_kernel = NULL;    // half spectrum of the ring kernel
+Complex *lenia_spectrum = NULL;  // half spectrum work buffer
+Complex *lenia_tmp = NULL;
+
+/**
+* @brief rounds up to the next power of two
+* @param n the value to round
+* @return the smallest power of two >= n
+*/
+int next_pow2(int n) {
+    int p = 2;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/**
+* @brief parses the Lenia parameter string
+* @param str the parameters, for example R13,m0.15,s0.017,T10,D1
+* @param params where to store the parsed parameters
+* @return true if the parameters were valid
+*/
+bool parse_lenia_params(const char *str, LeniaParams *params) {
+    LeniaParams p = { 13, 0.15f, 0.017f, 0.1f, true };
+    char buf[128];
+    if (strlen(str) >= sizeof(buf)) {
+        fprintf(stderr, "[E] Parameter string too long!\n");
+        return false;
+    }
+    strcpy(buf, str);
+
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        bool ok = true;
+        switch (tok[0]) {
+            case 'R':
+                p.radius = atoi(tok+1);
+                ok = p.radius >= 1;
+                break;
+            case 'm':
+                p.mu = strtof(tok+1, NULL);
+                break;
+            case 's':
+                p.sigma = strtof(tok+1, NULL);
+                ok = p.sigma > 0;
+                break;
+            case 'T':
+                ok = atof(tok+1) > 0;
+                p.dt = ok ? 1.0f / strtof(tok+1, NULL) : 0;
+                break;
+            case 'D':
+                p.dither = atoi(tok+1) != 0;
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "[E] Invalid Lenia parameter: %s\n", tok);
+            return false;
+        }
+    }
+    *params = p;
+    return true;
+}
+
+/**
+* @brief sets up the Lenia world, its kernel spectrum and a random starting patch
+* @return true if the parameters were valid and memory was allocated
+*/
+bool lenia_init(int argc, char **argv) {
+    if (!parse_lenia_params((argc > 0) ? argv[0] : "", &lenia)) {
+        return false;
+    }
+    lenia_width = next_pow2(board_width);
+    lenia_height = next_pow2(board_height);
+    if (2*lenia.radius >= lenia_width || 2*lenia.radius >= lenia_height) {
+        fprintf(stderr, "[E] Kernel radius too large for the board!\n");
+        return false;
+    }
+
+    int cells = lenia_width * lenia_height;
+    int spectrum = lenia_height * ((lenia_width/2)+1);
+    int longest = (lenia_width > lenia_height) ? lenia_width : lenia_height;
+    lenia_cells = (float*) calloc(cells, sizeof(float));
+    lenia_potential = (float*) calloc(cells, sizeof(float));
+    lenia_kernel = (Complex*) calloc(spectrum, sizeof(Complex));
+    lenia_spectrum = (Complex*) calloc(spectrum, sizeof(Complex));
+    lenia_tmp = (Complex*) calloc(longest, sizeof(Complex));
+    if (!lenia_cells || !lenia_potential || !lenia_kernel || !lenia_spectrum || !lenia_tmp) {
+        fprintf(stderr, "Error allocating memory for the Lenia board\n");
+        return false;
+    }
+
+    // ring kernel, a smooth bump peaking half way out, wrapped around the origin
+    float total = 0;
+    int r = lenia.radius;
+    for (int dy = -r; dy <= r; dy++) {
+        for (int dx = -r; dx <= r; dx++) {
+            float d = sqrtf((float) (dx*dx) + (dy*dy)) / r;
+            if (d <= 0 || d >= 1) {
+                continue;
+            }
+            float k = expf(4 - (1 / (d * (1-d))));
+            int x = (dx + lenia_width) & (lenia_width-1);
+            int y = (dy + lenia_height) & (lenia_height-1);
+            lenia_potential[(y*lenia_width)+x] = k;
+            total += k;
+        }
+    }
+    for (int i = 0; i < cells; i++) {
+        lenia_potential[i] /= total;
+    }
+    rfft2d(lenia_potential, lenia_kernel, lenia_width, lenia_height, lenia_tmp);
+
+    // the soup picks the live cells of the patch, each gets a uniform value
+    int patch = 4 * r;
+    patch = (patch < lenia_width) ? patch : lenia_width;
+    patch = (patch < lenia_height) ? patch : lenia_height;
+    Board b;
+    if (!board_init(&b, patch, patch)) {
+        return false;
+    }
+    bool ok = soup_fill(&b, &soup, 0, 0, patch, patch);
+    for (int y = 0; y < patch; y++) {
+        for (int x = 0; x < patch; x++) {
+            int px = ((lenia_width - patch) / 2) + x;
+            int py = ((lenia_height - patch) / 2) + y;
+            if (board_get(&b, x, y)) {
+                lenia_cells[(py*lenia_width)+px] = (float) soup_value(&soup, x, y) / UINT32_MAX;
+            }
+        }
+    }
+    board_destroy(&b);
+    return ok;
+}
+
+/**
+* @brief advances the Lenia world by one time step
+*/
+void lenia_step() {
+    int spectrum = lenia_height * ((lenia_width/2)+1);
+    rfft2d(lenia_cells, lenia_spectrum, lenia_width, lenia_height, lenia_tmp);
+    for (int i = 0; i < spectrum; i++) {
+        Complex a = lenia_spectrum[i];
+        Complex k = lenia_kernel[i];
+        lenia_spectrum[i].re = (a.re*k.re) - (a.im*k.im);
+        lenia_spectrum[i].im = (a.re*k.im) + (a.im*k.re);
+    }
+    irfft2d(lenia_spectrum, lenia_potential, lenia_width, lenia_height, lenia_tmp);
+
+    float inv = 1 / (2 * lenia.sigma * lenia.sigma);
+    for (int i = 0; i < lenia_width * lenia_height; i++) {
+        float d = lenia_potential[i] - lenia.mu;
+        float growth = (2 * expf(-d * d * inv)) - 1;
+        float v = lenia_cells[i] + (lenia.dt * growth);
+        lenia_cells[i] = (v < 0) ? 0 : (v > 1) ? 1 : v;
+    }
+}
+
+/*
+* 4x4 ordered dither thresholds, used to show continuous values with on/off pixels
+*/
+const uint8_t bayer4[16] = {
+     0,  8,  2, 10,
+    12,  4, 14,  6,
+     3, 11,  1,  9,
+    15,  7, 13,  5
+};
+
+/**
+* @brief copies the centre of the Lenia world onto the screen
+* @param scr a pointer to the current screen
+*/
+void lenia_draw(Screen *scr) {
+    int x0 = (lenia_width - scr->width) / 2;
+    int y0 = (lenia_height - scr->height) / 2;
+    for (int y = 0; y < scr->height; y++) {
+        for (int x = 0; x < scr->width; x++) {
+            int bx = x0 + x;
+            int by = y0 + y;
+            bool on = false;
+            if (bx >= 0 && bx < lenia_width && by >= 0 && by < lenia_height) {
+                float v = lenia_cells[(by*lenia_width)+bx];
+                float t = lenia.dither ? (bayer4[((y&3)*4)+(x&3)] + 0.5f) / 16 : 0.5f;
+                on = v > t;
+            }
+            setScreenPixel(scr, x,y, on);
+        }
+    }
+}
+
+void lenia_destroy() {
+    free(lenia_cells);
+    free(lenia_potential);
+    free(lenia_kernel);
+    free(lenia_spectrum);
+    free(lenia_tmp);
+    lenia_cells = NULL;
+    lenia_potential = NULL;
+    lenia_kernel = NULL;
+    lenia_spectrum = NULL;
+    lenia_tmp = NULL;
+}
+
+/*
+* 3D Life on a bit packed cube of voxels. Rules are written in Bays' ElEuFlFu form,
+* so 4555 means a live cell survives with 4 to 5 of its 26 neighbors and a dead cell
+* is born with exactly 5. Ranges past 9 can be written with commas: 4,5,5,5.
+*/
+typedef struct {
+    int size;        // the cube side in voxels
+    int words;       // 64 bit words per row of voxels
+    uint64_t *data;  // (size+2)^2 rows, with dead rows and slices around the cube
+} Volume;
+
+/**
+* @brief initializes and allocates an empty Volume
+* @param v a pointer to the volume
+* @param size the side of the cube in voxels
+* @return true if the memory was allocated
+*/
+bool volume_init(Volume *v, int size) {
+    v->size = size;
+    v->words = (size+63) / 64;
+    v->data = (uint64_t*) calloc((size_t) (size+2) * (size+2) * v->words, sizeof(uint64_t));
+    if (!v->data) {
+        fprintf(stderr, "Error allocating memory for a %d^3 volume\n", size);
+        return false;
+    }
+    return true;
+}
+
+void volume_destroy(Volume *v) {
+    if (v->data) {
+        free(v->data);
+        v->data = NULL;
+    }
+}
+
+/**
+* @brief gets a row of voxels, rows and slices -1 and size are dead
+* @param v a pointer to the volume
+* @param y the row
+* @param z the slice
+* @return a pointer to the first word of the row
+*/
+uint64_t *volume_row(const Volume *v, int y, int z) {
+    return &v->data[(((size_t) (z+1) * (v->size+2)) + (y+1)) * v->words];
+}
+
+typedef struct {
+    uint32_t survive;  // bit n set when a live voxel with n neighbors survives
+    uint32_t birth;    // bit n set when a dead voxel with n neighbors is born
+} Rule3d;
+
+/**
+* @brief parses a Bays 3D rule
+* @param str the rule, for example 4555 or 5,7,6,6
+* @param rule where to store the parsed rule
+* @return true if the rule was valid
+*/
+bool parse_rule3d(const char *str, Rule3d *rule) {
+    int v[4];
+    bool ok;
+    if (strchr(str, ',')) {
+        ok = sscanf(str, "%d,%d,%d,%d", &v[0], &v[1], &v[2], &v[3]) == 4;
+    } else {
+        ok = strlen(str) == 4;
+        for (int i = 0; ok && i < 4; i++) {
+            ok = str[i] >= '0' && str[i] <= '9';
+            v[i] = str[i] - '0';
+        }
+    }
+    for (int i = 0; ok && i < 4; i++) {
+        ok = v[i] >= 0 && v[i] <= 26;
+    }
+    if (!ok || v[0] > v[1] || v[2] > v[3]) {
+        fprintf(stderr, "[E] Invalid 3D rule: %s\n", str);
+        return false;
+    }
+    rule->survive = 0;
+    rule->birth = 0;
+    for (int n = v[0]; n <= v[1]; n++) {
+        rule->survive |= 1u << n;
+    }
+    for (int n = v[2]; n <= v[3]; n++) {
+        rule->birth |= 1u << n;
+    }
+    return true;
+}
+
+Rule3d life3d_rule;
+Volume life3d_volumes[2];
+Volume *life3d_cur = &life3d_volumes[0];
+Volume *life3d_next = &life3d_volumes[1];
+int life3d_slice;          // the slice shown on screen
+bool life3d_projection;    // show every slice ORed together instead
+uint64_t *life3d_scratch;  // the planar and row sums of each band, one band per thread
+size_t life3d_scratch_words;  // words of scratch per band
+
+/**
+* @brief sums the 3x3 square around every voxel of a slice, the centre included
+*
+* Rows are first summed horizontally into 2 bit counts, then three of those
+* are added vertically into the 4 bit planes of out, size * words words each.
+* @param v the volume
+* @param z the slice, may be -1 or size for the dead slices
+* @param out 4 planes receiving the sums
+* @param hs scratch for the horizontal sums, (size+2) * words
+* @param hc scratch for the horizontal carries, (size+2) * words
+*/
+void life3d_planar(const Volume *v, int z, uint64_t *out, uint64_t *hs, uint64_t *hc) {
+    int words = v->words;
+    size_t plane = (size_t) v->size * words;
+    for (int y = -1; y <= v->size; y++) {
+        const uint64_t *r = volume_row(v, y, z);
+        uint64_t *s = &hs[(size_t) (y+1) * words];
+        uint64_t *c = &hc[(size_t) (y+1) * words];
+        for (int w = 0; w < words; w++) {
+            FULL_ADD(s[w], c[w], ROW_WEST(r, w, words), r[w], ROW_EAST(r, w, words));
+        }
+    }
+    for (int y = 0; y < v->size; y++) {
+        const uint64_t *sa = &hs[(size_t) y * words], *sc = sa + words, *sb = sc + words;
+        const uint64_t *ca = &hc[(size_t) y * words], *cc = ca + words, *cb = cc + words;
+        uint64_t *q0 = &out[(size_t) y * words];
+        uint64_t *q1 = q0 + plane, *q2 = q1 + plane, *q3 = q2 + plane;
+        for (int w = 0; w < words; w++) {
+            uint64_t k1, t, k2, k3;
+            FULL_ADD(q0[w], k1, sa[w], sc[w], sb[w]);
+            FULL_ADD(t, k2, ca[w], cc[w], cb[w]);
+            HALF_ADD(q1[w], k3, t, k1);
+            HALF_ADD(q2[w], q3[w], k2, k3);
+        }
+    }
+}
+
+typedef struct {
+    const Volume *src;
+    Volume *dst;
+    const Rule3d *rule;
+    int slices;  // slices per task
+} Life3dJob;
+
+/**
+* @brief steps one band of slices, each planar sum is computed once and used by
+*        the three slices that touch it
+*/
+void life3d_task(int task, void *arg) {
+    Life3dJob *job = (Life3dJob*) arg;
+    const Volume *src = job->src;
+    int size = src->size;
+    int words = src->words;
+    int z0 = task * job->slices;
+    int z1 = (z0 + job->slices < size) ? z0 + job->slices : size;
+    size_t plane = (size_t) size * words;
+
+    uint64_t *buf = life3d_scratch + (task * life3d_scratch_words);
+    uint64_t *sums[3] = { buf, buf + (4*plane), buf + (8*plane) };
+    uint64_t *hs = buf + (12*plane);
+    uint64_t *hc = hs + ((size_t) (size+2) * words);
+
+    life3d_planar(src, z0-1, sums[(z0+2) % 3], hs, hc);
+    life3d_planar(src, z0, sums[z0 % 3], hs, hc);
+    for (int z = z0; z < z1; z++) {
+        life3d_planar(src, z+1, sums[(z+1) % 3], hs, hc);
+        const uint64_t *a = sums[(z+2) % 3], *b = sums[z % 3], *c = sums[(z+1) % 3];
+        for (int y = 0; y < size; y++) {
+            const uint64_t *alive = volume_row(src, y, z);
+            uint64_t *out = volume_row(job->dst, y, z);
+            size_t o = (size_t) y * words;
+            for (int w = 0; w < words; w++) {
+                // add the three 4 bit planar sums into a 5 bit total, the centre included
+                uint64_t t0, t1, t2, t3, t4, k, s0, s1, s2, s3, s4;
+                HALF_ADD(t0, k, a[o+w], b[o+w]);
+                FULL_ADD(t1, k, a[o+w+plane], b[o+w+plane], k);
+                FULL_ADD(t2, k, a[o+w+(2*plane)], b[o+w+(2*plane)], k);
+                FULL_ADD(t3, t4, a[o+w+(3*plane)], b[o+w+(3*plane)], k);
+                HALF_ADD(s0, k, t0, c[o+w]);
+                FULL_ADD(s1, k, t1, c[o+w+plane], k);
+                FULL_ADD(s2, k, t2, c[o+w+(2*plane)], k);
+                FULL_ADD(s3, k, t3, c[o+w+(3*plane)], k);
+                s4 = t4 ^ k;
+
+                // live voxels count themselves, so their survival is checked one higher
+                uint64_t next = 0;
+                uint64_t cell = alive[w];
+                uint32_t counts = job->rule->birth | (job->rule->survive << 1);
+                for (int n = 0; counts; n++, counts >>= 1) {
+                    if (!(counts & 1)) {
+                        continue;
+                    }
+                    uint64_t eq = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) & ((n & 4) ? s2 : ~s2)
+                                & ((n & 8) ? s3 : ~s3) & ((n & 16) ? s4 : ~s4);
+                    uint64_t who = (((job->rule->birth >> n) & 1) ? ~cell : 0)
+                                 | ((n > 0 && ((job->rule->survive >> (n-1)) & 1)) ? cell : 0);
+                    next |= eq & who;
+                }
+                out[w] = next;
+            }
+            if (size & 63) {
+                out[words-1] &= (1ULL << (size & 63)) - 1;
+            }
+        }
+    }
+}
+
+/**
+* @brief sets up the 3D engine with a random soup in the middle of the cube
+* @return true if the rule was valid and memory was allocated
+*/
+bool life3d_init(int argc, char **argv) {
+    if (!parse_rule3d((argc > 0) ? argv[0] : "4555", &life3d_rule)) {
+        return false;
+    }
+    int size = (argc > 1) ? atoi(argv[1]) : 64;
+    if (size < 3) {
+        fprintf(stderr, "[E] Invalid volume size: %d\n", size);
+        return false;
+    }
+    if (!volume_init(&life3d_volumes[0], size) || !volume_init(&life3d_volumes[1], size)) {
+        return false;
+    }
+    size_t plane = (size_t) size * life3d_volumes[0].words;
+    life3d_scratch_words = (3*4*plane) + (2 * (size_t) (size+2) * life3d_volumes[0].words);
+    life3d_scratch = (uint64_t*) malloc(thread_count * life3d_scratch_words * sizeof(uint64_t));
+    if (!life3d_scratch) {
+        fprintf(stderr, "Error allocating memory for the 3D step\n");
+        return false;
+    }
+
+    // every slice of the soup cube is a soup of its own, seeded one apart
+    int side = (size < 32) ? size : size / 2;
+    int o = (size - side) / 2;
+    Board b;
+    if (!board_init(&b, side, side)) {
+        return false;
+    }
+    for (int z = o; z < o + side; z++) {
+        Soup s = soup;
+        s.seed += z - o;
+        if (!soup_fill(&b, &s, 0, 0, side, side)) {
+            board_destroy(&b);
+            return false;
+        }
+        for (int y = o; y < o + side; y++) {
+            uint64_t *r = volume_row(life3d_cur, y, z);
+            for (int x = o; x < o + side; x++) {
+                if (board_get(&b, x - o, y - o)) {
+                    r[x >> 6] |= 1ULL << (x & 63);
+                }
+            }
+        }
+    }
+    board_destroy(&b);
+    life3d_slice = size / 2;
+    life3d_projection = false;
+    return true;
+}
+
+/**
+* @brief advances the volume by one generation, bands of slices run in parallel
+*/
+void life3d_step() {
+    int size = life3d_cur->size;
+    // every band has its own scratch, and whole bands share the most planar sums
+    int bands = thread_count;
+    Life3dJob job = { life3d_cur, life3d_next, &life3d_rule, (size + bands - 1) / bands };
+    run_parallel((size + job.slices - 1) / job.slices, life3d_task, &job);
+    Volume *t = life3d_cur;
+    life3d_cur = life3d_next;
+    life3d_next = t;
+}
+
+/**
+* @brief draws the centre of the selected slice, or of every slice ORed together
+* @param scr a pointer to the current screen
+*/
+void life3d_draw(Screen *scr) {
+    const Volume *v = life3d_cur;
+    int x0 = (v->size - scr->width) / 2;
+    int y0 = (v->size - scr->height) / 2;
+    uint64_t *row = (uint64_t*) malloc(v->words * sizeof(uint64_t));
+    if (!row) {
+        return;
+    }
+    for (int y = 0; y < scr->height; y++) {
+        int by = y0 + y;
+        memset(row, 0, v->words * sizeof(uint64_t));
+        if (by >= 0 && by < v->size) {
+            int z0 = life3d_projection ? 0 : life3d_slice;
+            int z1 = life3d_projection ? v->size : life3d_slice + 1;
+            for (int z = z0; z < z1; z++) {
+                const uint64_t *r = volume_row(v, by, z);
+                for (int w = 0; w < v->words; w++) {
+                    row[w] |= r[w];
+                }
+            }
+        }
+        for (int x = 0; x < scr->width; x++) {
+            int bx = x0 + x;
+            bool on = bx >= 0 && bx < v->size && ((row[bx >> 6] >> (bx & 63)) & 1);
+            setScreenPixel(scr, x,y, on);
+        }
+    }
+    free(row);
+}
+
+/**
+* @brief , and . move through the slices, p toggles the projection
+* @param ch the key pressed
+*/
+void life3d_key(char ch) {
+    if (ch == ',' && life3d_slice > 0) {
+        life3d_slice--;
+    } else if (ch == '.' && life3d_slice < life3d_cur->size - 1) {
+        life3d_slice++;
+    } else if (ch == 'p') {
+        life3d_projection = !life3d_projection;
+    }
+}
+
+void life3d_destroy() {
+    volume_destroy(&life3d_volumes[0]);
+    volume_destroy(&life3d_volumes[1]);
+    free(life3d_scratch);
+    life3d_scratch = NULL;
+}
+
+/*
+* Golly rule tables (@TABLE sections of .rule files, or bare .table files).
+* The table is expanded once at load time into a dense lookup table indexed by the
+* centre state followed by the neighbor states in the table's order, each one a digit
+* in base n_states, so stepping a cell is a handful of multiply adds and one load.
+* Moore and von Neumann neighborhoods are supported, with every Golly symmetry.
+*/
+#define TABLE_MAX_LUT   (1 << 24)
+#define TABLE_MAX_VARS  256
+#define TABLE_UNSET     0xFF
+
+typedef struct {
+    int states;
+    int neighbors;  // 8 for Moore, 4 for von Neumann
+    uint8_t *lut;   // next state for every combination
+} RuleTable;
+
+typedef struct {
+    char name[32];
+    int count;
+    uint8_t values[256];
+} TableVar;
+
+typedef struct {
+    RuleTable *table;
+    TableVar vars[TABLE_MAX_VARS];
+    int nvars;
+    int perms[16][8];  // neighbor orders produced by the symmetries
+    int nperms;
+    bool permute;      // every ordering of the neighbors
+} TableParser;
+
+/**
+* @brief sets the parser symmetries from a Golly symmetry name
+* @param p the parser
+* @param name the symmetry name
+* @return true if the symmetry is known for the neighborhood
+*/
+bool table_symmetry(TableParser *p, const char *name) {
+    int k = p->table->neighbors;
+    int step = (k == 8) ? 2 : 1;  // how far a 90 degree turn moves a neighbor
+    int rotations = 1;
+    bool reflect = false;
+    p->permute = false;
+
+    if (strcmp(name, "none") == 0) {
+        rotations = 1;
+    } else if (strcmp(name, "rotate4") == 0) {
+        rotations = 4;
+    } else if (strcmp(name, "rotate8") == 0 && k == 8) {
+        rotations = 8;
+        step = 1;
+    } else if (strcmp(name, "reflect_horizontal") == 0) {
+        reflect = true;
+    } else if (strcmp(name, "rotate4reflect") == 0) {
+        rotations = 4;
+        reflect = true;
+    } else if (strcmp(name, "rotate8reflect") == 0 && k == 8) {
+        rotations = 8;
+        step = 1;
+        reflect = true;
+    } else if (strcmp(name, "permute") == 0) {
+        p->permute = true;
+    } else {
+        return false;
+    }
+
+    p->nperms = 0;
+    for (int r = 0; r < rotations; r++) {
+        for (int f = 0; f <= (int) reflect; f++) {
+            for (int i = 0; i < k; i++) {
+                int j = (i + (r*step)) % k;
+                p->perms[p->nperms][i] = f ? (k - j) % k : j;
+            }
+            p->nperms++;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief finds a variable by name
+* @param p the parser
+* @param name the variable name
+* @param len the length of the name
+* @return the variable index or -1
+*/
+int table_find_var(TableParser *p, const char *name, int len) {
+    for (int i = 0; i < p->nvars; i++) {
+        if ((int) strlen(p->vars[i].name) == len && strncmp(p->vars[i].name, name, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+* @brief parses a state or variable token
+* @param p the parser
+* @param tok the token text
+* @param len the token length
+* @param out receives the state, or -1-var for a variable
+* @return true if the token was a valid state or a known variable
+*/
+bool table_token(TableParser *p, const char *tok, int len, int *out) {
+    if (len > 0 && tok[0] >= '0' && tok[0] <= '9') {
+        int v = 0;
+        for (int i = 0; i < len; i++) {
+            if (tok[i] < '0' || tok[i] > '9') {
+                return false;
+            }
+            v = (v*10) + (tok[i] - '0');
+        }
+        *out = v;
+        return v < p->table->states;
+    }
+    int var = table_find_var(p, tok, len);
+    *out = -1 - var;
+    return var >= 0;
+}
+
+/**
+* @brief splits a line into state or variable tokens on commas and whitespace,
+*        tables with at most 10 states may also run single digits together
+* @param p the parser
+* @param line the line
+* @param out receives the tokens
+* @param max the size of out
+* @return the number of tokens or -1 on error
+*/
+int table_tokens(TableParser *p, const char *line, int *out, int max) {
+    bool compact = p->table->states <= 10 && !strpbrk(line, ", \t{");
+    int n = 0;
+    const char *s = line;
+    while (*s) {
+        if (*s == ',' || *s == ' ' || *s == '\t' || *s == '{' || *s == '}') {
+            s++;
+            continue;
+        }
+        int len = 1;
+        if (!compact) {
+            while (s[len] && !strchr(", \t{}", s[len])) {
+                len++;
+            }
+        }
+        if (n >= max || !table_token(p, s, len, &out[n])) {
+            return -1;
+        }
+        n++;
+        s += len;
+    }
+    return n;
+}
+
+/**
+* @brief writes one concrete transition to the lookup table under every symmetry,
+*        entries already written by an earlier transition win as they do in Golly
+* @param p the parser
+* @param v the centre, the neighbors and the new state
+*/
+void table_store(TableParser *p, const int *v) {
+    RuleTable *t = p->table;
+    int k = t->neighbors;
+    int n[8];
+    memcpy(n, v+1, k * sizeof(int));
+
+    if (p->permute) {
+        // every distinct ordering, walked in lexicographic order from the sorted one
+        for (int i = 1; i < k; i++) {
+            for (int j = i; j > 0 && n[j-1] > n[j]; j--) {
+                int tmp = n[j];
+                n[j] = n[j-1];
+                n[j-1] = tmp;
+            }
+        }
+        // the orderings of a neighbourhood are always set together, so once the
+        // sorted one is set an earlier binding has covered them all
+        uint32_t sorted = v[0];
+        for (int i = 0; i < k; i++) {
+            sorted = (sorted * t->states) + n[i];
+        }
+        if (t->lut[sorted] != TABLE_UNSET) {
+            return;
+        }
+        while (true) {
+            uint32_t idx = v[0];
+            for (int i = 0; i < k; i++) {
+                idx = (idx * t->states) + n[i];
+            }
+            if (t->lut[idx] == TABLE_UNSET) {
+                t->lut[idx] = v[k+1];
+            }
+            int i = k - 2;
+            while (i >= 0 && n[i] >= n[i+1]) {
+                i--;
+            }
+            if (i < 0) {
+                break;
+            }
+            int j = k - 1;
+            while (n[j] <= n[i]) {
+                j--;
+            }
+            int tmp = n[i];
+            n[i] = n[j];
+            n[j] = tmp;
+            for (int a = i+1, b = k-1; a < b; a++, b--) {
+                tmp = n[a];
+                n[a] = n[b];
+                n[b] = tmp;
+            }
+        }
+        return;
+    }
+
+    for (int s = 0; s < p->nperms; s++) {
+        uint32_t idx = v[0];
+        for (int i = 0; i < k; i++) {
+            idx = (idx * t->states) + n[p->perms[s][i]];
+        }
+        if (t->lut[idx] == TABLE_UNSET) {
+            t->lut[idx] = v[k+1];
+        }
+    }
+}
+
+/**
+* @brief expands a transition over every binding of its variables, a variable
+*        used more than once takes the same value everywhere in the transition
+* @param p the parser
+* @param tok the parsed tokens
+* @param val the concrete values being built
+* @param pos the token being expanded
+*/
+void table_expand(TableParser *p, const int *tok, int *val, int pos) {
+    int len = p->table->neighbors + 2;
+    if (pos == len) {
+        table_store(p, val);
+        return;
+    }
+    if (tok[pos] >= 0) {
+        val[pos] = tok[pos];
+        table_expand(p, tok, val, pos+1);
+        return;
+    }
+    for (int i = 0; i < pos; i++) {
+        if (tok[i] == tok[pos]) {
+            val[pos] = val[i];  // already bound
+            table_expand(p, tok, val, pos+1);
+            return;
+        }
+    }
+    TableVar *var = &p->vars[-1 - tok[pos]];
+    for (int i = 0; i < var->count; i++) {
+        val[pos] = var->values[i];
+        table_expand(p, tok, val, pos+1);
+    }
+}
+
+/**
+* @brief parses one line of a table
+* @param p the parser
+* @param line the line, comments already removed
+* @return true if the line was valid
+*/
+bool table_line(TableParser *p, char *line) {
+    RuleTable *t = p->table;
+    char *colon = strchr(line, ':');
+    char word[64];
+
+    if (colon && sscanf(line, " n_states : %d", &t->states) == 1) {
+        return t->states >= 2 && t->states < TABLE_UNSET;
+    }
+    if (colon && sscanf(line, " neighborhood : %63s", word) == 1) {
+        if (strcmp(word, "Moore") == 0) {
+            t->neighbors = 8;
+        } else if (strcmp(word, "vonNeumann") == 0) {
+            t->neighbors = 4;
+        } else {
+            fprintf(stderr, "[E] Unsupported neighborhood: %s\n", word);
+            return false;
+        }
+        return true;
+    }
+    if (colon && sscanf(line, " symmetries : %63s", word) == 1) {
+        if (!t->states || !t->neighbors) {
+            fprintf(stderr, "[E] symmetries must come after n_states and neighborhood\n");
+            return false;
+        }
+        if (t->lut) {
+            fprintf(stderr, "[E] symmetries can only be given once\n");
+            return false;
+        }
+        double size = pow(t->states, t->neighbors + 1);
+        if (size > TABLE_MAX_LUT) {
+            fprintf(stderr, "[E] Lookup table for %d states is too large\n", t->states);
+            return false;
+        }
+        t->lut = (uint8_t*) malloc((size_t) size);
+        if (!t->lut) {
+            fprintf(stderr, "Error allocating memory for the rule table\n");
+            return false;
+        }
+        memset(t->lut, TABLE_UNSET, (size_t) size);
+        if (!table_symmetry(p, word)) {
+            fprintf(stderr, "[E] Unsupported symmetry: %s\n", word);
+            return false;
+        }
+        return true;
+    }
+    if (!t->lut) {
+        fprintf(stderr, "[E] Variables and transitions must come after the header\n");
+        return false;
+    }
+
+    char name[32];
+    int used = -1;
+    if (sscanf(line, " var %31[^= \t] = %n", name, &used) == 1 && used >= 0) {
+        if (p->nvars >= TABLE_MAX_VARS) {
+            return false;
+        }
+        TableVar *var = &p->vars[p->nvars];
+        strcpy(var->name, name);
+        var->count = 0;
+        int tok[256];
+        int n = table_tokens(p, line + used, tok, 256);
+        if (n <= 0) {
+            return false;
+        }
+        for (int i = 0; i < n; i++) {
+            // a variable inside a variable contributes all of its values
+            TableVar *inner = (tok[i] < 0) ? &p->vars[-1 - tok[i]] : NULL;
+            int count = inner ? inner->count : 1;
+            for (int j = 0; j < count && var->count < 256; j++) {
+                var->values[var->count++] = inner ? inner->values[j] : (uint8_t) tok[i];
+            }
+        }
+        p->nvars++;
+        return true;
+    }
+
+    int tok[10];
+    int val[10];
+    if (table_tokens(p, line, tok, 10) != t->neighbors + 2) {
+        return false;
+    }
+    table_expand(p, tok, val, 0);
+    return true;
+}
+
+/**
+* @brief loads a rule table from a .rule or .table file
+* @param path the file to read
+* @param table where to store the table
+* @return true if the table was loaded
+*/
+bool load_rule_table(const char *path, RuleTable *table) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[E] Cannot open rule table: %s\n", path);
+        return false;
+    }
+
+    // .rule files keep the table in a @TABLE section, .table files are all table
+    char line[1024];
+    bool sectioned = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "@TABLE", 6) == 0) {
+            sectioned = true;
+            break;
+        }
+    }
+    if (!sectioned) {
+        rewind(f);
+    }
+
+    TableParser *p = (TableParser*) calloc(1, sizeof(TableParser));
+    if (!p) {
+        fclose(f);
+        return false;
+    }
+    memset(table, 0, sizeof(RuleTable));
+    p->table = table;
+
+    bool ok = true;
+    int lineno = 0;
+    while (ok && fgets(line, sizeof(line), f)) {
+        lineno++;
+        if (sectioned && line[0] == '@') {
+            break;
+        }
+        line[strcspn(line, "#\r\n")] = '\0';
+        if (strspn(line, " \t") == strlen(line)) {
+            continue;
+        }
+        ok = table_line(p, line);
+        if (!ok) {
+            fprintf(stderr, "[E] %s: invalid table line %d\n", path, lineno);
+        }
+    }
+    fclose(f);
+    free(p);
+
+    if (ok && !table->lut) {
+        fprintf(stderr, "[E] %s: no table found\n", path);
+        ok = false;
+    }
+    if (!ok) {
+        free(table->lut);
+        table->lut = NULL;
+        return false;
+    }
+
+    // combinations no transition matched leave the centre unchanged
+    size_t size = (size_t) pow(table->states, table->neighbors + 1);
+    size_t per_state = size / table->states;
+    for (size_t i = 0; i < size; i++) {
+        if (table->lut[i] == TABLE_UNSET) {
+            table->lut[i] = (uint8_t) (i / per_state);
+        }
+    }
+    return true;
+}
+
+/*
+* Table driven engine, one byte per cell with a dead ring around the board
+*/
+RuleTable table_rule;
+uint8_t *table_cells[2] = { NULL, NULL };
+int table_cur = 0;
+
+/**
+* @brief gets a cell of the table board, -1 and board_width/height are the dead ring
+*/
+uint8_t *table_cell(uint8_t *cells, int x, int y) {
+    return &cells[((y+1) * (board_width+2)) + x+1];
+}
+
+/**
+* @brief loads a rule table and seeds the board with a random soup of its states
+* @return true if the table was loaded and memory was allocated
+*/
+bool table_init(int argc, char **argv) {
+    if (argc < 1) {
+        fprintf(stderr, "[E] The table engine needs a .rule or .table file\n");
+        return false;
+    }
+    if (!load_rule_table(argv[0], &table_rule)) {
+        return false;
+    }
+    size_t size = (size_t) (board_width+2) * (board_height+2);
+    table_cells[0] = (uint8_t*) calloc(size, sizeof(uint8_t));
+    table_cells[1] = (uint8_t*) calloc(size, sizeof(uint8_t));
+    if (!table_cells[0] || !table_cells[1]) {
+        fprintf(stderr, "Error allocating memory for the table board\n");
+        return false;
+    }
+    // live cells of the soup take any of the non zero states
+    Board b;
+    if (!board_init(&b, board_width, board_height)) {
+        return false;
+    }
+    bool ok = soup_fill(&b, &soup, 0, 0, board_width, board_height);
+    for (int y = 0; y < board_height; y++) {
+        for (int x = 0; x < board_width; x++) {
+            if (board_get(&b, x, y)) {
+                *table_cell(table_cells[0], x, y) = 1 + (soup_value(&soup, x, y) % (table_rule.states - 1));
+            }
+        }
+    }
+    board_destroy(&b);
+    table_cur = 0;
+    return ok;
+}
+
+/**
+* @brief advances the table board by one generation
+*/
+void table_step() {
+    uint8_t *src = table_cells[table_cur];
+    uint8_t *dst = table_cells[table_cur ^ 1];
+    uint32_t n = table_rule.states;
+    int stride = board_width + 2;
+    for (int y = 0; y < board_height; y++) {
+        uint8_t *c = table_cell(src, 0, y);
+        uint8_t *out = table_cell(dst, 0, y);
+        for (int x = 0; x < board_width; x++, c++) {
+            uint32_t idx;
+            if (table_rule.neighbors == 8) {
+                // C,N,NE,E,SE,S,SW,W,NW
+                idx = (((((((((c[0] * n) + c[-stride]) * n + c[1-stride]) * n + c[1]) * n
+                    + c[1+stride]) * n + c[stride]) * n + c[stride-1]) * n + c[-1]) * n) + c[-1-stride];
+            } else {
+                // C,N,E,S,W
+                idx = (((((c[0] * n) + c[-stride]) * n + c[1]) * n + c[stride]) * n) + c[-1];
+            }
+            out[x] = table_rule.lut[idx];
+        }
+    }
+    table_cur ^= 1;
+}
+
+/**
+* @brief copies the centre of the table board onto the screen, any non zero state is on
+* @param scr a pointer to the current screen
+*/
+void table_draw(Screen *scr) {
+    int x0 = (board_width - scr->width) / 2;
+    int y0 = (board_height - scr->height) / 2;
+    for (int y = 0; y < scr->height; y++) {
+        for (int x = 0; x < scr->width; x++) {
+            int bx = x0 + x;
+            int by = y0 + y;
+            bool on = bx >= 0 && bx < board_width && by >= 0 && by < board_height
+                   && *table_cell(table_cells[table_cur], bx, by) != 0;
+            setScreenPixel(scr, x,y, on);
+        }
+    }
+}
+
+void table_destroy() {
+    free(table_rule.lut);
+    free(table_cells[0]);
+    free(table_cells[1]);
+    table_rule.lut = NULL;
+    table_cells[0] = NULL;
+    table_cells[1] = NULL;
+}
+
+/**
+* @brief reads a pattern in RLE format, multi state files use . for 0 and A to X for 1 to 24
+* @param f the open file, positioned at the start
+* @param set called for every non zero cell
+* @param arg passed through to set
+* @param width receives the width from the header
+* @param height receives the height from the header
+* @return true if the file was a valid RLE pattern
+*/
+bool read_rle(FILE *f, void (*set)(int x, int y, int state, void *arg), void *arg,
+              int *width, int *height) {
+    char line[1024];
+    bool header = false;
+    int x = 0, y = 0, run = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (!header) {
+            if (sscanf(line, " x = %d , y = %d", width, height) != 2) {
+                return false;
+            }
+            header = true;
+            continue;
+        }
+        for (char *c = line; *c; c++) {
+            if (*c >= '0' && *c <= '9') {
+                run = (run*10) + (*c - '0');
+                continue;
+            }
+            int n = run ? run : 1;
+            run = 0;
+            if (*c == '!') {
+                return true;
+            } else if (*c == '$') {
+                y += n;
+                x = 0;
+            } else if (*c == 'b' || *c == '.') {
+                x += n;
+            } else if (*c == 'o' || (*c >= 'A' && *c <= 'X')) {
+                int state = (*c == 'o') ? 1 : (*c - 'A' + 1);
+                for (int i = 0; i < n; i++) {
+                    set(x++, y, state, arg);
+                }
+            }
+        }
+    }
+    return header;
+}
+
+/*
+* WireWorld, states follow Golly: 0 empty, 1 electron head, 2 electron tail, 3 conductor.
+* Only the electrons are visited each step: heads bump a counter on their conductor
+* neighbors and the ones hit once or twice become the new heads, so a step costs
+* in proportion to the signals rather than the size of the circuit.
+*/
+#define WW_EMPTY 0
+#define WW_HEAD  1
+#define WW_TAIL  2
+#define WW_WIRE  3
+
+uint8_t *ww_cells = NULL;    // states with a dead ring, (board_width+2) * (board_height+2)
+uint8_t *ww_counts = NULL;   // head neighbor counts of candidate cells, zero between steps
+int *ww_heads = NULL;        // indices of the electron heads
+int *ww_tails = NULL;        // indices of the electron tails
+int *ww_candidates = NULL;   // conductor cells touched by a head this step
+int ww_nheads = 0;
+int ww_ntails = 0;
+int ww_stride;
+
+/**
+* @brief sets a WireWorld cell from the pattern loaders
+*/
+void ww_set(int x, int y, int state, void *arg) {
+    (void) arg;
+    if (x >= 0 && x < board_width && y >= 0 && y < board_height && state <= WW_WIRE) {
+        ww_cells[((y+1) * ww_stride) + x+1] = state;
+    }
+}
+
+/**
+* @brief reads the size of a text circuit, # is conductor, @ a head and ~ a tail
+*/
+void ww_text_size(FILE *f, int *width, int *height) {
+    char line[4096];
+    *width = 0;
+    *height = 0;
+    while (fgets(line, sizeof(line), f)) {
+        int len = (int) strcspn(line, "\r\n");
+        *width = (len > *width) ? len : *width;
+        (*height)++;
+    }
+    rewind(f);
+}
+
+/**
+* @brief loads a circuit from an RLE or text file
+* @param path the file to read
+* @return true if the file was read
+*/
+bool ww_load(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[E] Cannot open circuit: %s\n", path);
+        return false;
+    }
+    char first[8] = "";
+    int c;
+    while ((c = fgetc(f)) == '#') {
+        while ((c = fgetc(f)) != EOF && c != '\n');
+    }
+    first[0] = (char) c;
+    rewind(f);
+
+    int width, height;
+    bool rle = first[0] == 'x';
+    if (rle) {
+        if (!read_rle(f, ww_set, NULL, &width, &height)) {
+            fprintf(stderr, "[E] %s: invalid RLE\n", path);
+            fclose(f);
+            return false;
+        }
+    } else {
+        char line[4096];
+        int y = 0;
+        ww_text_size(f, &width, &height);
+        while (fgets(line, sizeof(line), f)) {
+            for (int x = 0; line[x] && line[x] != '\n'; x++) {
+                int state = (line[x] == '#') ? WW_WIRE : (line[x] == '@') ? WW_HEAD
+                          : (line[x] == '~') ? WW_TAIL : WW_EMPTY;
+                if (state) {
+                    ww_set(x, y, state, NULL);
+                }
+            }
+            y++;
+        }
+    }
+    fclose(f);
+    if (width > board_width || height > board_height) {
+        fprintf(stderr, "[W] %s is %dx%d, larger than the board\n", path, width, height);
+    }
+    return true;
+}
+
+/**
+* @brief lays out a grid of clock loops of different lengths as a demo circuit
+*/
+void ww_demo() {
+    int y = 2;
+    for (int h = 3; y + h < board_height; h += 2) {
+        int x = 2;
+        for (int w = 4; x + w < board_width; w += 3) {
+            for (int i = 0; i < w; i++) {
+                ww_set(x+i, y, WW_WIRE, NULL);
+                ww_set(x+i, y+h-1, WW_WIRE, NULL);
+            }
+            for (int i = 0; i < h; i++) {
+                ww_set(x, y+i, WW_WIRE, NULL);
+                ww_set(x+w-1, y+i, WW_WIRE, NULL);
+            }
+            ww_set(x+1, y, WW_HEAD, NULL);
+            ww_set(x, y, WW_TAIL, NULL);
+            x += w + 2;
+        }
+        y += h + 2;
+    }
+}
+
+/**
+* @brief sets up WireWorld from a circuit file, or the demo circuit, and lists its electrons
+* @return true if the circuit was loaded and memory was allocated
+*/
+bool ww_init(int argc, char **argv) {
+    ww_stride = board_width + 2;
+    size_t size = (size_t) ww_stride * (board_height+2);
+    ww_cells = (uint8_t*) calloc(size, sizeof(uint8_t));
+    ww_counts = (uint8_t*) calloc(size, sizeof(uint8_t));
+    ww_heads = (int*) malloc(size * sizeof(int));
+    ww_tails = (int*) malloc(size * sizeof(int));
+    ww_candidates = (int*) malloc(size * sizeof(int));
+    if (!ww_cells || !ww_counts || !ww_heads || !ww_tails || !ww_candidates) {
+        fprintf(stderr, "Error allocating memory for the WireWorld board\n");
+        return false;
+    }
+
+    if (argc > 0) {
+        if (!ww_load(argv[0])) {
+            return false;
+        }
+    } else {
+        ww_demo();
+    }
+
+    ww_nheads = 0;
+    ww_ntails = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (ww_cells[i] == WW_HEAD) {
+            ww_heads[ww_nheads++] = (int) i;
+        } else if (ww_cells[i] == WW_TAIL) {
+            ww_tails[ww_ntails++] = (int) i;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief advances WireWorld by one generation, touching only electrons and their neighbors
+*/
+void ww_step() {
+    const int offsets[8] = { -ww_stride-1, -ww_stride, -ww_stride+1, -1, 1,
+                             ww_stride-1, ww_stride, ww_stride+1 };
+    int ncandidates = 0;
+    for (int i = 0; i < ww_nheads; i++) {
+        for (int k = 0; k < 8; k++) {
+            int n = ww_heads[i] + offsets[k];
+            if (ww_cells[n] == WW_WIRE && ww_counts[n]++ == 0) {
+                ww_candidates[ncandidates++] = n;
+            }
+        }
+    }
+
+    for (int i = 0; i < ww_ntails; i++) {
+        ww_cells[ww_tails[i]] = WW_WIRE;
+    }
+    for (int i = 0; i < ww_nheads; i++) {
+        ww_cells[ww_heads[i]] = WW_TAIL;
+    }
+
+    // the old heads become the tails, the head list is refilled from the candidates
+    int *t = ww_tails;
+    ww_tails = ww_heads;
+    ww_ntails = ww_nheads;
+    ww_heads = t;
+    ww_nheads = 0;
+    for (int i = 0; i < ncandidates; i++) {
+        int n = ww_candidates[i];
+        if (ww_counts[n] <= 2) {
+            ww_cells[n] = WW_HEAD;
+            ww_heads[ww_nheads++] = n;
+        }
+        ww_counts[n] = 0;
+    }
+}
+
+/**
+* @brief draws the centre of the circuit one character per cell: a full block for heads,
+*        two bars for tails and a single bar for conductor
+* @param scr a pointer to the current screen
+*/
+void ww_draw(Screen *scr) {
+    const uint8_t glyphs[4] = { 0, 0b111111, 0b110011, 0b001100 };
+    int cols = scr->width / 2;
+    int rows = scr->height / 3;
+    int x0 = (board_width - cols) / 2;
+    int y0 = (board_height - rows) / 2;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            int bx = x0 + x;
+            int by = y0 + y;
+            uint8_t g = 0;
+            if (bx >= 0 && bx < board_width && by >= 0 && by < board_height) {
+                g = glyphs[ww_cells[((by+1) * ww_stride) + bx+1]];
+            }
+            for (int i = 0; i < 6; i++) {
+                setScreenPixel(scr, (x*2) + (i & 1), (y*3) + (i >> 1), (g >> (5-i)) & 1);
+            }
+        }
+    }
+}
+
+void ww_destroy() {
+    free(ww_cells);
+    free(ww_counts);
+    free(ww_heads);
+    free(ww_tails);
+    free(ww_candidates);
+    ww_cells = NULL;
+    ww_counts = NULL;
+    ww_heads = NULL;
+    ww_tails = NULL;
+    ww_candidates = NULL;
+}
+
+/*
+* Margolus block automata. The board is split into 2x2 blocks, on even generations
+* aligned to even coordinates and on odd ones shifted by one cell, and every block is
+* replaced through a 16 entry table. A block is numbered with its top left cell as 1,
+* top right 2, bottom left 4 and bottom right 8, the same order as Golly's MS,D rules.
+* The board wraps in both directions and its width is a whole number of words.
+*/
+typedef struct {
+    uint8_t next[16];
+    uint8_t prev[16];  // the inverse table, only meaningful for reversible rules
+    bool reversible;
+} BlockRule;
+
+/**
+* @brief builds one of the named block rules
+* @param name bbm, critters or tron
+* @param table receives the 16 entries
+* @return true if the name was known
+*/
+bool block_rule_named(const char *name, uint8_t table[16]) {
+    for (int i = 0; i < 16; i++) {
+        int count = __builtin_popcount(i);
+        int rot180 = ((i & 1) << 3) | ((i & 2) << 1) | ((i & 4) >> 1) | ((i & 8) >> 3);
+        if (strcmp(name, "bbm") == 0) {
+            // a lone ball crosses the block, two balls meeting head on leave sideways
+            table[i] = (count == 1) ? rot180 : (i == 6) ? 9 : (i == 9) ? 6 : i;
+        } else if (strcmp(name, "critters") == 0) {
+            // two cells stay, anything else flips, and a flipped three turns around
+            if (count == 2) {
+                table[i] = i;
+            } else {
+                int flipped = ~i & 15;
+                table[i] = (count == 3) ? (((flipped & 1) << 3) | ((flipped & 2) << 1)
+                                        | ((flipped & 4) >> 1) | ((flipped & 8) >> 3)) : flipped;
+            }
+        } else if (strcmp(name, "tron") == 0) {
+            table[i] = (count == 0 || count == 4) ? (~i & 15) : i;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief parses a block rule: a name, or 16 entries as in MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15
+* @param str the rule
+* @param rule where to store the rule
+* @return true if the rule was valid
+*/
+bool parse_block_rule(const char *str, BlockRule *rule) {
+    if (!block_rule_named(str, rule->next)) {
+        if (strncmp(str, "MS,D", 4) == 0) {
+            str += 4;
+        }
+        int count = 0;
+        const char *s = str;
+        while (count < 16 && *s) {
+            char *end;
+            long v = strtol(s, &end, 10);
+            if (end == s || v < 0 || v > 15) {
+                break;
+            }
+            rule->next[count++] = (uint8_t) v;
+            s = end;
+            if (*s == ';' || *s == ',') {
+                s++;
+            }
+        }
+        if (count != 16 || *s) {
+            fprintf(stderr, "[E] Invalid block rule: %s\n", str);
+            return false;
+        }
+    }
+
+    uint16_t seen = 0;
+    for (int i = 0; i < 16; i++) {
+        seen |= 1 << rule->next[i];
+        rule->prev[rule->next[i]] = (uint8_t) i;
+    }
+    rule->reversible = seen == 0xFFFF;
+    return true;
+}
+
+/**
+* @brief replaces every block of a row pair through a table, 32 blocks per word
+*
+* The left cells of the blocks sit on the even bits. The 16 possible blocks are
+* decoded into minterms once per word and each output cell is the OR of the
+* minterms whose table entry sets it.
+* @param table the block table
+* @param top the top row of the blocks, updated in place
+* @param bottom the bottom row of the blocks, updated in place
+* @param words the words per row
+*/
+void block_rows(const uint8_t table[16], uint64_t *top, uint64_t *bottom, int words) {
+    const uint64_t even = 0x5555555555555555ULL;
+    for (int w = 0; w < words; w++) {
+        uint64_t in[4] = { top[w] & even, (top[w] >> 1) & even,
+                           bottom[w] & even, (bottom[w] >> 1) & even };
+        uint64_t out[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < 16; i++) {
+            if (!table[i]) {
+                continue;
+            }
+            uint64_t m = even;
+            for (int k = 0; k < 4; k++) {
+                m &= ((i >> k) & 1) ? in[k] : ~in[k];
+            }
+            for (int k = 0; k < 4; k++) {
+                out[k] |= ((table[i] >> k) & 1) ? m : 0;
+            }
+        }
+        top[w] = out[0] | (out[1] << 1);
+        bottom[w] = out[2] | (out[3] << 1);
+    }
+}
+
+BlockRule block_rule;
+Board block_board;
+long block_gen;          // the generation, its parity picks the block offset
+bool block_backwards;    // stepping with the inverse table
+uint64_t *block_tmp = NULL;
+
+/**
+* @brief applies one block generation at a given offset
+* @param table the block table
+* @param phase 0 for blocks at even coordinates, 1 for blocks shifted by one
+*/
+void block_phase(const uint8_t table[16], int phase) {
+    Board *b = &block_board;
+    int words = b->words;
+    uint64_t *top = block_tmp;
+    uint64_t *bottom = block_tmp + words;
+    for (int y = phase; y < b->height + phase; y += 2) {
+        uint64_t *rt = board_row(b, y);
+        uint64_t *rb = board_row(b, (y+1) % b->height);
+        if (!phase) {
+            block_rows(table, rt, rb, words);
+            continue;
+        }
+        // move the odd columns onto the even bits, wrapping around the board
+        for (int w = 0; w < words; w++) {
+            int n = (w+1) % words;
+            top[w] = (rt[w] >> 1) | (rt[n] << 63);
+            bottom[w] = (rb[w] >> 1) | (rb[n] << 63);
+        }
+        block_rows(table, top, bottom, words);
+        for (int w = 0; w < words; w++) {
+            int p = (w + words - 1) % words;
+            rt[w] = (top[w] << 1) | (top[p] >> 63);
+            rb[w] = (bottom[w] << 1) | (bottom[p] >> 63);
+        }
+    }
+}
+
+/**
+* @brief sets up the block engine with a random soup in the middle of the board
+* @return true if the rule was valid and memory was allocated
+*/
+bool block_init(int argc, char **argv) {
+    if (!parse_block_rule((argc > 0) ? argv[0] : "critters", &block_rule)) {
+        return false;
+    }
+    int width = ((board_width + 63) / 64) * 64;
+    int height = (board_height + 1) & ~1;
+    if (!board_init(&block_board, width, height)) {
+        return false;
+    }
+    block_tmp = (uint64_t*) malloc(2 * block_board.words * sizeof(uint64_t));
+    if (!block_tmp) {
+        fprintf(stderr, "Error allocating memory for the block engine\n");
+        return false;
+    }
+
+    block_gen = 0;
+    block_backwards = false;
+    int side = (width < height) ? width/2 : height/2;
+    if (soup.symmetry == SYMMETRY_C4 || soup.symmetry == SYMMETRY_D8) {
+        return soup_fill(&block_board, &soup, (width-side)/2, (height-side)/2, side, side);
+    }
+    return soup_fill(&block_board, &soup, width/4, height/4, ((3*width)/4) - (width/4),
+                     ((3*height)/4) - (height/4));
+}
+
+/**
+* @brief advances the block engine by one generation, or undoes one when running backwards
+*/
+void block_step() {
+    if (!block_backwards) {
+        block_phase(block_rule.next, block_gen & 1);
+        block_gen++;
+    } else if (block_gen > 0) {
+        block_gen--;
+        block_phase(block_rule.prev, block_gen & 1);
+    }
+}
+
+void block_draw(Screen *scr) {
+    board_draw(&block_board, NEIGHBORHOOD_MOORE, scr);
+}
+
+/**
+* @brief r reverses time for reversible rules
+* @param ch the key pressed
+*/
+void block_key(char ch) {
+    if (ch == 'r' && block_rule.reversible) {
+        block_backwards = !block_backwards;
+    }
+}
+
+void block_destroy() {
+    board_destroy(&block_board);
+    free(block_tmp);
+    block_tmp = NULL;
+}
+
+/*
+* One dimensional automata shown as a scrolling spacetime diagram. A rule is either a
+* Wolfram elementary rule number (0 to 255) or T<code>R<range> for a totalistic rule
+* where bit s of code gives the next state of a cell whose 2*range+1 cell window
+* holds s live cells. The row wraps around and is a whole number of words long.
+* With "all" every elementary rule is run side by side, which is meant for headless
+* sweeps with -n, the final density of each rule is printed at the end.
+*/
+#define ECA_MAX_RANGE 3
+
+typedef struct {
+    bool totalistic;
+    int range;
+    uint32_t table;  // next state by neighborhood pattern (elementary) or live count
+} Rule1d;
+
+/**
+* @brief parses a one dimensional rule
+* @param str the rule, for example 110 or T20R2
+* @param rule where to store the rule
+* @return true if the rule was valid
+*/
+bool parse_rule1d(const char *str, Rule1d *rule) {
+    char *end;
+    if (str[0] == 'T') {
+        rule->totalistic = true;
+        rule->table = (uint32_t) strtoul(str+1, &end, 10);
+        rule->range = (*end == 'R') ? (int) strtol(end+1, &end, 10) : 1;
+        if (*end || rule->range < 1 || rule->range > ECA_MAX_RANGE
+            || (rule->table >> ((2*rule->range)+2))) {
+            fprintf(stderr, "[E] Invalid totalistic rule: %s\n", str);
+            return false;
+        }
+        return true;
+    }
+    rule->totalistic = false;
+    rule->range = 1;
+    rule->table = (uint32_t) strtoul(str, &end, 10);
+    if (end == str || *end || rule->table > 255) {
+        fprintf(stderr, "[E] Invalid elementary rule: %s\n", str);
+        return false;
+    }
+    return true;
+}
+
+/**
+* @brief steps a wrapping row of cells, 64 cells per word
+* @param rule the rule
+* @param src the current row
+* @param dst the next row
+* @param words the words in the row
+*/
+void row1d_step(const Rule1d *rule, const uint64_t *src, uint64_t *dst, int words) {
+    // all-ones or zero per table entry so the inner loop has no branches
+    uint64_t on[2*ECA_MAX_RANGE + 2];
+    int entries = rule->totalistic ? (2*rule->range) + 2 : 8;
+    for (int i = 0; i < entries; i++) {
+        on[i] = ((rule->table >> i) & 1) ? ~0ULL : 0;
+    }
+
+    for (int w = 0; w < words; w++) {
+        uint64_t prev = src[(w > 0) ? w-1 : words-1];
+        uint64_t cur = src[w];
+        uint64_t next = src[(w+1 < words) ? w+1 : 0];
+        uint64_t out = 0;
+        if (!rule->totalistic) {
+            // cell x sits at bit x, so its left neighbor comes in from the lower bit
+            uint64_t l = (cur << 1) | (prev >> 63);
+            uint64_t r = (cur >> 1) | (next << 63);
+            for (int p = 0; p < 8; p++) {
+                out |= on[p] & ((p & 4) ? l : ~l) & ((p & 2) ? cur : ~cur) & ((p & 1) ? r : ~r);
+            }
+        } else {
+            uint64_t p0 = cur, p1 = 0, p2 = 0;
+            for (int k = 1; k <= rule->range; k++) {
+                uint64_t in[2] = { (cur << k) | (prev >> (64-k)), (cur >> k) | (next << (64-k)) };
+                for (int i = 0; i < 2; i++) {
+                    uint64_t c0 = p0 & in[i];
+                    p0 ^= in[i];
+                    uint64_t c1 = p1 & c0;
+                    p1 ^= c0;
+                    p2 ^= c1;
+                }
+            }
+            for (int s = 0; s < entries; s++) {
+                out |= on[s] & ((s & 1) ? p0 : ~p0) & ((s & 2) ? p1 : ~p1) & ((s & 4) ? p2 : ~p2);
+            }
+        }
+        dst[w] = out;
+    }
+}
+
+Rule1d eca_rules[256];
+int eca_count;             // 1, or 256 when sweeping every elementary rule
+int eca_words;
+uint64_t *eca_rows[2] = { NULL, NULL };  // eca_count rows of eca_words each
+int eca_line;              // the next pixel row of the spacetime diagram
+
+/**
+* @brief sets up the row(s) with a random soup, or a single live cell with "single"
+* @return true if the rule was valid and memory was allocated
+*/
+bool eca_init(int argc, char **argv) {
+    const char *rule = (argc > 0) ? argv[0] : "110";
+    if (strcmp(rule, "all") == 0) {
+        eca_count = 256;
+        for (int i = 0; i < 256; i++) {
+            Rule1d r = { false, 1, (uint32_t) i };
+            eca_rules[i] = r;
+        }
+    } else {
+        eca_count = 1;
+        if (!parse_rule1d(rule, &eca_rules[0])) {
+            return false;
+        }
+    }
+    bool single = argc > 1 && strcmp(argv[1], "single") == 0;
+
+    eca_words = (board_width + 63) / 64;
+    size_t size = (size_t) eca_count * eca_words;
+    eca_rows[0] = (uint64_t*) calloc(size, sizeof(uint64_t));
+    eca_rows[1] = (uint64_t*) calloc(size, sizeof(uint64_t));
+    if (!eca_rows[0] || !eca_rows[1]) {
+        fprintf(stderr, "Error allocating memory for the 1D rows\n");
+        return false;
+    }
+
+    for (int w = 0; w < eca_words; w++) {
+        uint64_t v = soup_word(&soup, w, 0);
+        for (int i = 0; i < eca_count; i++) {
+            eca_rows[0][((size_t) i * eca_words) + w] = single ? 0 : v;
+        }
+    }
+    if (single) {
+        int x = (eca_words * 64) / 2;
+        for (int i = 0; i < eca_count; i++) {
+            eca_rows[0][((size_t) i * eca_words) + (x >> 6)] = 1ULL << (x & 63);
+        }
+    }
+    eca_line = 0;
+    return true;
+}
+
+void eca_task(int task, void *arg) {
+    (void) arg;
+    size_t o = (size_t) task * eca_words;
+    row1d_step(&eca_rules[task], eca_rows[0] + o, eca_rows[1] + o, eca_words);
+}
+
+/**
+* @brief advances every row by one generation, one task per rule
+*/
+void eca_step() {
+    run_parallel(eca_count, eca_task, NULL);
+    uint64_t *t = eca_rows[0];
+    eca_rows[0] = eca_rows[1];
+    eca_rows[1] = t;
+}
+
+/**
+* @brief appends the middle of the first row to the spacetime diagram
+*
+* Once the screen is full it scrolls up one character row at a time, the glyphs
+* already rendered move with it and only the character row being written is rendered.
+* @param scr a pointer to the current screen
+*/
+void eca_draw(Screen *scr) {
+    int rows = scr->height / 3;
+    if (eca_line >= rows * 3) {
+        scrollScreen(scr, 1);
+        eca_line -= 3;
+    }
+    int x0 = ((eca_words * 64) - scr->width) / 2;
+    for (int x = 0; x < scr->width; x++) {
+        int bx = x0 + x;
+        bool on = bx >= 0 && bx < eca_words * 64 && ((eca_rows[0][bx >> 6] >> (bx & 63)) & 1);
+        setScreenPixel(scr, x, eca_line, on);
+    }
+    renderScreenRows(scr, eca_line / 3, (eca_line / 3) + 1);
+    scr->flags |= SCREEN_SELF_RENDER;
+    eca_line++;
+}
+
+/**
+* @brief prints the live cell density of each rule after a headless run
+*/
+void eca_report() {
+    double cells = (double) eca_words * 64;
+    for (int i = 0; i < eca_count; i++) {
+        long pop = 0;
+        for (int w = 0; w < eca_words; w++) {
+            pop += __builtin_popcountll(eca_rows[0][((size_t) i * eca_words) + w]);
+        }
+        if (eca_count > 1) {
+            printf("rule %3d density %.4f\n", i, pop / cells);
+        } else {
+            printf("density %.4f\n", pop / cells);
+        }
+    }
+}
+
+void eca_destroy() {
+    free(eca_rows[0]);
+    free(eca_rows[1]);
+    eca_rows[0] = NULL;
+    eca_rows[1] = NULL;
+}
+
+/*
+* Timeline branches. The board is cut into 64x64 chunks shared between branches by
+* reference count and copied only when a branch writes to a shared one. Each step is
+* memoized on the rule and the pointers of a chunk and its 8 neighbours, and new chunks
+* are interned by content, so regions that have not diverged are computed once and
+* stay shared, and memory grows with the divergence instead of the number of
+* branches. Empty chunks are NULL and the board is rounded up to whole chunks.
+*
+* Arguments: [rule] [gen] [fork...], every fork is [rule][:x,y...] and is made from
+* branch 0 at generation gen with its own rule and the listed cells toggled.
+*/
+#define CHUNK       64
+#define BRANCH_MAX  8
+
+typedef struct {
+    int refs;
+    uint64_t rows[CHUNK];  // bit i of row y is the cell at x = i
+} Chunk;
+
+typedef struct {
+    Rule rule;
+    Chunk **chunks;  // branch_cw * branch_ch, row major
+} Branch;
+
+typedef struct {
+    long gen;           // step the entry belongs to, older entries count as empty
+    Rule rule;
+    Chunk *key[9];
+    Chunk *result;
+} ChunkMemo;
+
+int branch_cw, branch_ch;  // chunks across and down
+Branch branches[BRANCH_MAX];
+int branch_count;
+long branch_gen;
+long branch_chunks;        // chunks allocated across all branches
+ChunkMemo *branch_memo;
+ChunkMemo *branch_intern;  // chunks made this step by content, only gen and result are used
+size_t branch_memo_size;   // a power of two, for both tables
+Board branch_src, branch_dst;  // 3x1 chunks plus a row above and below, to step one chunk
+
+long branch_fork_gen;
+int branch_fork_count;
+char **branch_fork_specs;
+
+Chunk *chunk_new() {
+    Chunk *c = (Chunk*) calloc(1, sizeof(Chunk));
+    if (!c) {
+        fprintf(stderr, "Error allocating memory for a chunk\n");
+        exit(1);
+    }
+    c->refs = 1;
+    branch_chunks++;
+    return c;
+}
+
+void chunk_release(Chunk *c) {
+    if (c && --c->refs == 0) {
+        free(c);
+        branch_chunks--;
+    }
+}
+
+/**
+* @brief gets a chunk of a branch, chunks outside the board are empty
+*/
+Chunk *branch_chunk(const Branch *br, int cx, int cy) {
+    if (cx < 0 || cx >= branch_cw || cy < 0 || cy >= branch_ch) {
+        return NULL;
+    }
+    return br->chunks[(cy * branch_cw) + cx];
+}
+
+bool branch_get(const Branch *br, int x, int y) {
+    if (x < 0 || y < 0) {
+        return false;
+    }
+    Chunk *c = branch_chunk(br, x / CHUNK, y / CHUNK);
+    return c && ((c->rows[y % CHUNK] >> (x % CHUNK)) & 1);
+}
+
+/**
+* @brief toggles a cell, copying its chunk first if another branch shares it
+*/
+void branch_toggle(Branch *br, int x, int y) {
+    if (x < 0 || y < 0 || x >= branch_cw * CHUNK || y >= branch_ch * CHUNK) {
+        return;
+    }
+    Chunk **slot = &br->chunks[((y / CHUNK) * branch_cw) + (x / CHUNK)];
+    if (!*slot) {
+        *slot = chunk_new();
+    } else if ((*slot)->refs > 1) {
+        Chunk *copy = chunk_new();
+        memcpy(copy->rows, (*slot)->rows, sizeof(copy->rows));
+        (*slot)->refs--;
+        *slot = copy;
+    }
+    (*slot)->rows[y % CHUNK] ^= 1ULL << (x % CHUNK);
+}
+
+/**
+* @brief steps one chunk from its neighbourhood with the regular kernels
+* @return the new chunk, NULL if it came out empty
+*/
+Chunk *chunk_step(const Rule *rule, Chunk *const key[9]) {
+    for (int y = -1; y <= CHUNK; y++) {
+        int ky = (y < 0) ? 0 : (y < CHUNK) ? 1 : 2;
+        int ry = (y + CHUNK) % CHUNK;
+        uint64_t *row = board_row(&branch_src, y+1);
+        for (int kx = 0; kx < 3; kx++) {
+            Chunk *c = key[(ky * 3) + kx];
+            row[kx] = c ? c->rows[ry] : 0;
+        }
+    }
+    board_step_rows(rule, &branch_src, &branch_dst, 1, CHUNK+1, NULL);
+
+    Chunk *out = NULL;
+    for (int y = 0; y < CHUNK; y++) {
+        uint64_t v = board_row(&branch_dst, y+1)[1];
+        if (v && !out) {
+            out = chunk_new();
+        }
+        if (out) {
+            out->rows[y] = v;
+        }
+    }
+    return out;
+}
+
+/**
+* @brief swaps a freshly stepped chunk for an equal one made earlier in the same step
+*
+* Without this, a chunk next to a diverged one would get a new pointer even when its
+* cells came out the same, and the divergence would spread a chunk per step.
+*/
+Chunk *chunk_intern(Chunk *c) {
+    if (!c) {
+        return NULL;
+    }
+    uint64_t h = 0;
+    for (int y = 0; y < CHUNK; y++) {
+        h = (h ^ c->rows[y]) * 0x9E3779B97F4A7C15ULL;
+    }
+    size_t i = (h >> 17) & (branch_memo_size - 1);
+    for (;; i = (i + 1) & (branch_memo_size - 1)) {
+        ChunkMemo *m = &branch_intern[i];
+        if (m->gen != branch_gen) {
+            m->gen = branch_gen;
+            m->result = c;
+            return c;
+        }
+        if (memcmp(m->result->rows, c->rows, sizeof(c->rows)) == 0) {
+            chunk_release(c);
+            m->result->refs++;
+            return m->result;
+        }
+    }
+}
+
+/**
+* @brief steps a chunk through the memo, sharing the result with any branch that
+* has the same rule and the same neighbourhood
+*/
+Chunk *chunk_step_memo(const Rule *rule, Chunk *const key[9]) {
+    uint64_t h = ((uint64_t) rule->birth << 24) | ((uint64_t) rule->survive << 8) | rule->neighborhood;
+    for (int i = 0; i < 9; i++) {
+        h = (h ^ (uintptr_t) key[i]) * 0x9E3779B97F4A7C15ULL;
+    }
+    size_t i = (h >> 17) & (branch_memo_size - 1);
+    for (;; i = (i + 1) & (branch_memo_size - 1)) {
+        ChunkMemo *m = &branch_memo[i];
+        if (m->gen != branch_gen) {
+            m->gen = branch_gen;
+            m->rule = *rule;
+            memcpy(m->key, key, sizeof(m->key));
+            m->result = chunk_intern(chunk_step(rule, key));
+            return m->result;
+        }
+        if (m->rule.birth == rule->birth && m->rule.survive == rule->survive
+            && m->rule.neighborhood == rule->neighborhood && memcmp(m->key, key, sizeof(m->key)) == 0) {
+            if (m->result) {
+                m->result->refs++;
+            }
+            return m->result;
+        }
+    }
+}
+
+/**
+* @brief forks branch 0 with the rule and toggled cells of a spec such as B36/S23:10,12
+* @return false if the spec was invalid
+*/
+bool branch_fork(const char *spec) {
+    if (branch_count >= BRANCH_MAX) {
+        fprintf(stderr, "[E] At most %d branches\n", BRANCH_MAX);
+        return false;
+    }
+    Branch *br = &branches[branch_count];
+    br->rule = branches[0].rule;
+    char rule[32];
+    if (sscanf(spec, "%31[^:]", rule) == 1 && !parse_rule(rule, &br->rule)) {
+        return false;
+    }
+    br->chunks = (Chunk**) malloc((size_t) branch_cw * branch_ch * sizeof(Chunk*));
+    if (!br->chunks) {
+        fprintf(stderr, "Error allocating memory for a branch\n");
+        return false;
+    }
+    for (int i = 0; i < branch_cw * branch_ch; i++) {
+        br->chunks[i] = branches[0].chunks[i];
+        if (br->chunks[i]) {
+            br->chunks[i]->refs++;
+        }
+    }
+    branch_count++;
+    for (const char *p = strchr(spec, ':'); p; p = strchr(p+1, ':')) {
+        int x, y;
+        if (sscanf(p+1, "%d,%d", &x, &y) != 2) {
+            fprintf(stderr, "[E] Invalid cell in fork: %s\n", p+1);
+            return false;
+        }
+        branch_toggle(br, x, y);
+    }
+    return true;
+}
+
+/**
+* @brief sets up branch 0 from the soup, forks are made when their generation is reached
+* @return true if the arguments were valid
+*/
+bool branch_init(int argc, char **argv) {
+    branch_count = 0;
+    branch_gen = 0;
+    branch_chunks = 0;
+    branch_cw = (board_width + CHUNK - 1) / CHUNK;
+    branch_ch = (board_height + CHUNK - 1) / CHUNK;
+    Branch *br = &branches[0];
+    if (!parse_rule((argc > 0) ? argv[0] : "B3/S23", &br->rule)) {
+        return false;
+    }
+    branch_fork_gen = (argc > 1) ? atol(argv[1]) : 0;
+    branch_fork_count = (argc > 2) ? argc-2 : 0;
+    branch_fork_specs = argv+2;
+
+    branch_memo_size = 64;
+    while (branch_memo_size < (size_t) 2 * BRANCH_MAX * branch_cw * branch_ch) {
+        branch_memo_size *= 2;
+    }
+    branch_memo = (ChunkMemo*) malloc(branch_memo_size * sizeof(ChunkMemo));
+    branch_intern = (ChunkMemo*) malloc(branch_memo_size * sizeof(ChunkMemo));
+    br->chunks = (Chunk**) calloc((size_t) branch_cw * branch_ch, sizeof(Chunk*));
+    if (!branch_memo || !branch_intern || !br->chunks
+        || !board_init(&branch_src, 3*CHUNK, CHUNK+2) || !board_init(&branch_dst, 3*CHUNK, CHUNK+2)) {
+        fprintf(stderr, "Error allocating memory for the branch engine\n");
+        return false;
+    }
+    for (size_t i = 0; i < branch_memo_size; i++) {
+        branch_memo[i].gen = -1;
+        branch_intern[i].gen = -1;
+    }
+    branch_count = 1;
+
+    Board b;
+    if (!board_init(&b, board_width, board_height)) {
+        return false;
+    }
+    bool ok = soup_fill(&b, &soup, 0, 0, board_width, board_height);
+    for (int y = 0; y < board_height; y++) {
+        for (int x = 0; x < board_width; x++) {
+            if (board_get(&b, x, y)) {
+                branch_toggle(br, x, y);
+            }
+        }
+    }
+    board_destroy(&b);
+    return ok;
+}
+
+/**
+* @brief makes any pending forks, then advances every branch by one generation
+*/
+void branch_step() {
+    if (branch_gen == branch_fork_gen) {
+        for (int i = 0; i < branch_fork_count; i++) {
+            if (!branch_fork(branch_fork_specs[i])) {
+                exit(1);
+            }
+        }
+    }
+
+    size_t size = (size_t) branch_cw * branch_ch * sizeof(Chunk*);
+    for (int b = 0; b < branch_count; b++) {
+        Branch *br = &branches[b];
+        Chunk **next = (Chunk**) malloc(size);
+        if (!next) {
+            fprintf(stderr, "Error allocating memory for a branch\n");
+            exit(1);
+        }
+        for (int cy = 0; cy < branch_ch; cy++) {
+            for (int cx = 0; cx < branch_cw; cx++) {
+                Chunk *key[9];
+                for (int k = 0; k < 9; k++) {
+                    key[k] = branch_chunk(br, cx + (k % 3) - 1, cy + (k / 3) - 1);
+                }
+                next[(cy * branch_cw) + cx] = chunk_step_memo(&br->rule, key);
+            }
+        }
+        for (int i = 0; i < branch_cw * branch_ch; i++) {
+            chunk_release(br->chunks[i]);
+        }
+        free(br->chunks);
+        br->chunks = next;
+    }
+    branch_gen++;
+}
+
+/**
+* @brief forks branch 0 with its centre cell toggled
+*/
+void branch_key(char ch) {
+    if (ch == 'f' && branch_count < BRANCH_MAX) {
+        char spec[32];
+        snprintf(spec, sizeof(spec), ":%d,%d", board_width / 2, board_height / 2);
+        branch_fork(spec);
+    }
+}
+
+/**
+* @brief draws the centre of every branch side by side
+*/
+void branch_draw(Screen *scr) {
+    int panel = scr->width / branch_count;
+    for (int b = 0; b < branch_count; b++) {
+        for (int y = 0; y < scr->height; y++) {
+            int by = (board_height / 2) - (scr->height / 2) + y;
+            for (int x = 0; x < panel; x++) {
+                int bx = (board_width / 2) - (panel / 2) + x;
+                bool edge = (x == panel-1) && (b < branch_count-1);
+                setScreenPixel(scr, (b * panel) + x, y, edge || branch_get(&branches[b], bx, by));
+            }
+        }
+    }
+}
+
+/**
+* @brief prints the population of each branch and how many chunks they share
+*/
+void branch_report() {
+    long slots = 0;
+    for (int b = 0; b < branch_count; b++) {
+        long pop = 0;
+        for (int i = 0; i < branch_cw * branch_ch; i++) {
+            Chunk *c = branches[b].chunks[i];
+            if (c) {
+                slots++;
+                for (int y = 0; y < CHUNK; y++) {
+                    pop += __builtin_popcountll(c->rows[y]);
+                }
+            }
+        }
+        printf("branch %d population %ld\n", b, pop);
+    }
+    printf("%ld chunks in memory for %ld chunk slots (%ld KB)\n", branch_chunks, slots,
+           (branch_chunks * (long) sizeof(Chunk)) / 1024);
+}
+
+void branch_destroy() {
+    for (int b = 0; b < branch_count; b++) {
+        for (int i = 0; i < branch_cw * branch_ch; i++) {
+            chunk_release(branches[b].chunks[i]);
+        }
+        free(branches[b].chunks);
+    }
+    branch_count = 0;
+    free(branch_memo);
+    free(branch_intern);
+    branch_memo = NULL;
+    branch_intern = NULL;
+    board_destroy(&branch_src);
+    board_destroy(&branch_dst);
+}
+
+/*
+* Soup search in the manner of apgsearch. Every step runs SEARCH_TASK random 16x16
+* soups on each of four tasks per thread until their population turns periodic,
+* splits what is left into objects and counts each object under a canonical code.
+* Tasks are runs of soups with their own board and census, merged after the batch, so
+* threads never share anything while searching. The census is written to the results
+* file when the engine is destroyed.
+*
+* Codes follow apgcode: xs<pop> still lifes, xp<period> oscillators, xq<period>
+* spaceships, then the extended Wechsler form of the smallest phase and orientation.
+* Objects are clusters of cells within two cells of each other, so close pairs such
+* as bi-blocks count as one object, and anything too big or slow to classify is zz_.
+*/
+#define SEARCH_SIZE        256   // board the soups run on
+#define SEARCH_SOUP        16
+#define SEARCH_MAX_GEN     6000
+#define SEARCH_MAX_PERIOD  64    // periods classified, also the stabilization limit
+#define SEARCH_TASK        16    // soups per task
+#define SEARCH_CODE        128
+
+typedef struct {
+    char code[SEARCH_CODE];
+    long count;
+} CensusEntry;
+
+typedef struct {
+    CensusEntry *entries;  // open addressing, empty entries have count 0
+    size_t size;           // a power of two
+    size_t used;
+} Census;
+
+/*
+* A small pattern cut out of a board, bit x of rows[y] is the cell at (x, y) from
+* the top left of its bounding box.
+*/
+typedef struct {
+    int w, h;
+    int x0, y0;  // where the bounding box was on the board
+    int pop;
+    uint64_t rows[64];
+} Shape;
+
+/**
+* @brief counts n objects under a code
+* @return false if memory ran out
+*/
+bool census_add(Census *c, const char *code, long n) {
+    if ((c->used + 1) * 2 > c->size) {
+        Census bigger = { NULL, c->size ? c->size * 2 : 256, 0 };
+        bigger.entries = (CensusEntry*) calloc(bigger.size, sizeof(CensusEntry));
+        if (!bigger.entries) {
+            fprintf(stderr, "Error allocating memory for the census\n");
+            return false;
+        }
+        for (size_t i = 0; i < c->size; i++) {
+            if (c->entries[i].count) {
+                census_add(&bigger, c->entries[i].code, c->entries[i].count);
+            }
+        }
+        free(c->entries);
+        *c = bigger;
+    }
+    uint64_t h = 1469598103934665603ULL;
+    for (const char *p = code; *p; p++) {
+        h = (h ^ (uint8_t) *p) * 1099511628211ULL;
+    }
+    size_t i = h & (c->size - 1);
+    while (c->entries[i].count && strcmp(c->entries[i].code, code) != 0) {
+        i = (i + 1) & (c->size - 1);
+    }
+    if (!c->entries[i].count) {
+        snprintf(c->entries[i].code, SEARCH_CODE, "%s", code);
+        c->used++;
+    }
+    c->entries[i].count += n;
+    return true;
+}
+
+void census_clear(Census *c) {
+    free(c->entries);
+    c->entries = NULL;
+    c->size = 0;
+    c->used = 0;
+}
+
+/**
+* @brief finds the rows of a board holding live cells
+* @return false if the board is empty
+*/
+bool board_used_rows(const Board *b, int *y0, int *y1) {
+    *y0 = b->height;
+    *y1 = 0;
+    for (int y = 0; y < b->height; y++) {
+        const uint64_t *row = board_row(b, y);
+        for (int w = 0; w < b->words; w++) {
+            if (row[w]) {
+                *y0 = (y < *y0) ? y : *y0;
+                *y1 = y+1;
+                break;
+            }
+        }
+    }
+    return *y1 > *y0;
+}
+
+/**
+* @brief cuts the whole live pattern of a board into a Shape
+* @return false if the board is empty or the pattern is over 64 cells in either direction
+*/
+bool shape_from_board(const Board *b, Shape *s) {
+    int y0, y1;
+    s->pop = 0;
+    if (!board_used_rows(b, &y0, &y1) || y1 - y0 > 64) {
+        return false;
+    }
+    int x0 = b->width, x1 = 0;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *row = board_row(b, y);
+        for (int w = 0; w < b->words; w++) {
+            if (row[w]) {
+                int lo = (w*64) + __builtin_ctzll(row[w]);
+                int hi = (w*64) + 64 - __builtin_clzll(row[w]);
+                x0 = (lo < x0) ? lo : x0;
+                x1 = (hi > x1) ? hi : x1;
+                s->pop += __builtin_popcountll(row[w]);
+            }
+        }
+    }
+    if (x1 - x0 > 64) {
+        return false;
+    }
+    s->w = x1 - x0;
+    s->h = y1 - y0;
+    s->x0 = x0;
+    s->y0 = y0;
+    for (int y = 0; y < s->h; y++) {
+        const uint64_t *row = board_row(b, y0 + y);
+        int w = x0 >> 6, shift = x0 & 63;
+        uint64_t v = row[w] >> shift;
+        if (shift && w+1 < b->words) {
+            v |= row[w+1] << (64 - shift);
+        }
+        s->rows[y] = v & ((s->w == 64) ? ~0ULL : ((1ULL << s->w) - 1));
+    }
+    return true;
+}
+
+bool shape_equal(const Shape *a, const Shape *b) {
+    return a->w == b->w && a->h == b->h && memcmp(a->rows, b->rows, a->h * sizeof(uint64_t)) == 0;
+}
+
+/**
+* @brief writes a shape in extended Wechsler form under one of the 8 orientations
+* @param s the shape
+* @param orient bit 0 flips x, bit 1 flips y, bit 2 swaps x and y first
+* @param out receives the code, at least SEARCH_CODE chars
+* @return false if the code did not fit
+*/
+bool shape_wechsler(const Shape *s, int orient, char *out) {
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    int w = (orient & 4) ? s->h : s->w;
+    int h = (orient & 4) ? s->w : s->h;
+    int n = 0;
+    for (int strip = 0; strip < h; strip += 5) {
+        if (strip > 0) {
+            out[n++] = 'z';
+        }
+        int zeros = 0;
+        for (int x = 0; x < w; x++) {
+            int v = 0;
+            for (int k = 0; k < 5 && strip+k < h; k++) {
+                int tx = (orient & 1) ? w-1-x : x;
+                int ty = (orient & 2) ? h-1-(strip+k) : strip+k;
+                int sx = (orient & 4) ? ty : tx;
+                int sy = (orient & 4) ? tx : ty;
+                v |= (int) ((s->rows[sy] >> sx) & 1) << k;
+            }
+            if (v == 0) {
+                zeros++;
+                continue;
+            }
+            // runs of empty columns: 0, w for 2, x for 3 and y0..yz for 4 to 39
+            while (zeros > 0) {
+                if (n + 3 >= SEARCH_CODE) {
+                    return false;
+                }
+                if (zeros >= 4) {
+                    int run = (zeros > 39) ? 39 : zeros;
+                    out[n++] = 'y';
+                    out[n++] = digits[run - 4];
+                    zeros -= run;
+                } else {
+                    out[n++] = (zeros == 3) ? 'x' : (zeros == 2) ? 'w' : '0';
+                    zeros = 0;
+                }
+            }
+            if (n + 2 >= SEARCH_CODE) {
+                return false;
+            }
+            out[n++] = digits[v];
+        }
+    }
+    out[n] = '\0';
+    return true;
+}
+
+/**
+* @brief keeps the better of two codes, the shorter one or else the first in order
+*/
+void code_min(char *best, const char *code) {
+    size_t a = strlen(best), b = strlen(code);
+    if (a == 0 || b < a || (b == a && strcmp(code, best) < 0)) {
+        strcpy(best, code);
+    }
+}
+
+/**
+* @brief runs a lone object until it repeats and names it
+* @param rule the rule
+* @param obj a board holding only the object, with room around it, stepped in place
+* @param tmp a board of the same size
+* @param max_period the longest period looked for, at most SEARCH_MAX_PERIOD
+* @param code receives the apgcode
+*/
+void search_classify(const Rule *rule, Board *obj, Board *tmp, int max_period, char *code) {
+    Shape phases[SEARCH_MAX_PERIOD];
+    if (!shape_from_board(obj, &phases[0])) {
+        strcpy(code, "zz_LARGE");
+        return;
+    }
+    int pop = phases[0].pop;
+    for (int p = 1; p <= max_period; p++) {
+        board_step(rule, obj, tmp);
+        Board t = *obj;
+        *obj = *tmp;
+        *tmp = t;
+
+        Shape now;
+        if (!shape_from_board(obj, &now)) {
+            int y0, y1;
+            strcpy(code, board_used_rows(obj, &y0, &y1) ? "zz_LARGE" : "zz_DIES");
+            return;
+        }
+        if (!shape_equal(&now, &phases[0])) {
+            if (p < max_period) {
+                phases[p] = now;
+            }
+            continue;
+        }
+
+        bool moved = now.x0 != phases[0].x0 || now.y0 != phases[0].y0;
+        char best[SEARCH_CODE] = "", wechsler[SEARCH_CODE];
+        for (int i = 0; i < p; i++) {
+            for (int orient = 0; orient < 8; orient++) {
+                if (shape_wechsler(&phases[i], orient, wechsler)) {
+                    code_min(best, wechsler);
+                }
+            }
+        }
+        if (!best[0]) {
+            strcpy(code, "zz_LARGE");
+        } else if (moved) {
+            snprintf(code, SEARCH_CODE, "xq%d_%s", p, best);
+        } else if (p == 1) {
+            snprintf(code, SEARCH_CODE, "xs%d_%s", pop, best);
+        } else {
+            snprintf(code, SEARCH_CODE, "xp%d_%s", p, best);
+        }
+        if (strlen(code) >= SEARCH_CODE - 1) {
+            strcpy(code, "zz_LARGE");
+        }
+        return;
+    }
+    strcpy(code, "zz_UNKNOWN");
+}
+
+/**
+* @brief checks whether a population history has turned periodic
+* @param pops the population of every generation so far
+* @param g the last generation in pops
+* @param max_period the longest period looked for
+* @return the smallest p for which the last 4p+32 populations repeat, 0 if none
+*/
+int pops_periodic(const int *pops, int g, int max_period) {
+    for (int p = 1; p <= max_period; p++) {
+        int window = (4 * p) + 32;
+        if (g + 1 < window + p) {
+            break;
+        }
+        bool periodic = true;
+        for (int i = 0; i < window && periodic; i++) {
+            periodic = pops[g-i] == pops[g-i-p];
+        }
+        if (periodic) {
+            return p;
+        }
+    }
+    return 0;
+}
+
+/*
+* Escaping spaceships. A soup sends gliders and other ships off for good, so a board
+* that grows to follow them never stops growing and a fixed one breaks them up at
+* its edge. A cluster of live cells at the edge that lies more than SHIP_GAP cells
+* from everything else is run on its own, and if it comes back translated towards
+* that edge within SHIP_MAX_PERIOD generations it is removed. Its population goes on
+* being counted phase by phase, so the population history, and the stabilization
+* found from it, stay as if it were still there. A faster ship that would have
+* caught one up later is missed, as in apgsearch. Clusters that turn out not to be
+* escaping are only looked at again every SHIP_RECHECK generations.
+*/
+#define SHIP_GAP         8
+#define SHIP_MAX_PERIOD  16
+#define SHIP_MARGIN      (SHIP_MAX_PERIOD + 1)
+#define SHIP_CELLS       64  // larger clusters are not looked at
+#define SHIP_BOXES       8   // clusters that were not ships, skipped until the next recheck
+#define SHIP_RECHECK     16
+
+typedef struct {
+    int x0, y0, x1, y1;  // inclusive
+} ShipBox;
+
+typedef struct {
+    int period;
+    long start;                 // generation it was removed at
+    int pops[SHIP_MAX_PERIOD];  // its population from then on, over one period
+} ShipTrack;
+
+typedef struct {
+    Board a, b;         // where clusters are run, 64x64 plus the margins
+    long steady;        // population of the removed ships that is the same in every phase
+    ShipTrack *tracks;  // the removed ships whose population changes with the phase
+    int track_count;
+    int track_capacity;
+    int count;          // ships removed
+    ShipBox failed[SHIP_BOXES];
+    int failed_count;
+    long failed_gen;    // generation the failed boxes were cleared at
+} Ships;
+
+/**
+* @brief checks for live cells within two cells of the edge of a board whose width is
+* a multiple of 64
+*/
+bool board_near_edge(const Board *b) {
+    int edge_rows[4] = { 0, 1, b->height-2, b->height-1 };
+    for (int i = 0; i < 4; i++) {
+        const uint64_t *row = board_row(b, edge_rows[i]);
+        for (int w = 0; w < b->words; w++) {
+            if (row[w]) {
+                return true;
+            }
+        }
+    }
+    // the right edge is the top of the last word
+    for (int y = 2; y < b->height-2; y++) {
+        const uint64_t *row = board_row(b, y);
+        if ((row[0] & 3ULL) || (row[b->words-1] & (3ULL << 62))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ships_init(Ships *s) {
+    memset(s, 0, sizeof(Ships));
+    int side = 64 + (2 * SHIP_MARGIN);
+    if (!board_init(&s->a, side, side) || !board_init(&s->b, side, side)) {
+        return false;
+    }
+    return true;
+}
+
+void ships_reset(Ships *s) {
+    s->steady = 0;
+    s->track_count = 0;
+    s->count = 0;
+    s->failed_count = 0;
+    s->failed_gen = 0;
+}
+
+void ships_destroy(Ships *s) {
+    board_destroy(&s->a);
+    board_destroy(&s->b);
+    free(s->tracks);
+    memset(s, 0, sizeof(Ships));
+}
+
+/**
+* @brief the population of the ships removed so far at generation g
+*/
+long ships_pop(const Ships *s, long g) {
+    long pop = s->steady;
+    for (int i = 0; i < s->track_count; i++) {
+        const ShipTrack *t = &s->tracks[i];
+        pop += t->pops[(g - t->start) % t->period];
+    }
+    return pop;
+}
+
+/**
+* @brief puts a shape on the scratch boards, cut down to the shape and its margins
+*/
+void ship_place(Ships *s, const Shape *shape, Board *a, Board *b) {
+    int width = shape->w + (2 * SHIP_MARGIN), height = shape->h + (2 * SHIP_MARGIN);
+    int words = (width + 63) / 64;
+    *a = (Board) { width, height, words, s->a.data };
+    *b = (Board) { width, height, words, s->b.data };
+    memset(a->data, 0, (size_t) (height + 2) * words * sizeof(uint64_t));
+    memset(b->data, 0, (size_t) (height + 2) * words * sizeof(uint64_t));
+    for (int y = 0; y < shape->h; y++) {
+        for (int x = 0; x < shape->w; x++) {
+            if ((shape->rows[y] >> x) & 1) {
+                board_set(a, SHIP_MARGIN + x, SHIP_MARGIN + y, true);
+            }
+        }
+    }
+}
+
+/**
+* @brief runs a shape on its own to see whether it is a spaceship
+* @param dx receives how far it moves in a period, as does dy
+* @param pops receives its population over a period
+* @return the period, 0 if it did not come back translated
+*/
+int ship_period(Ships *s, const Rule *rule, const Shape *shape, int *dx, int *dy, int *pops) {
+    Board a, b;
+    ship_place(s, shape, &a, &b);
+    pops[0] = shape->pop;
+    for (int p = 1; p <= SHIP_MAX_PERIOD; p++) {
+        board_step(rule, &a, &b);
+        Board t = a;
+        a = b;
+        b = t;
+        Shape now;
+        if (!shape_from_board(&a, &now)) {
+            return 0;
+        }
+        if (shape_equal(&now, shape)) {
+            *dx = now.x0 - SHIP_MARGIN;
+            *dy = now.y0 - SHIP_MARGIN;
+            return (*dx || *dy) ? p : 0;
+        }
+        if (p < SHIP_MAX_PERIOD) {
+            pops[p] = now.pop;
+        }
+    }
+    return 0;
+}
+
+/**
+* @brief remembers a cluster that was not an escaping ship
+*/
+bool ship_fail(Ships *s, int x0, int y0, int x1, int y1) {
+    if (s->failed_count < SHIP_BOXES) {
+        s->failed[s->failed_count++] = (ShipBox) { x0, y0, x1, y1 };
+    }
+    return false;
+}
+
+/**
+* @brief removes the cluster holding (x, y) if it is a spaceship leaving the board
+* @param g the generation of the board
+* @param census counts the ship under its apgcode if not NULL
+* @return true if it was removed
+*/
+bool ship_escape(Ships *s, const Rule *rule, Board *b, int x, int y, long g, Census *census) {
+    for (int i = 0; i < s->failed_count; i++) {
+        ShipBox *f = &s->failed[i];
+        if (x >= f->x0 && x <= f->x1 && y >= f->y0 && y <= f->y1) {
+            return false;
+        }
+    }
+    int cells[SHIP_CELLS][2] = { { x, y } };
+    int n = 1, x0 = x, x1 = x, y0 = y, y1 = y;
+    for (int i = 0; i < n; i++) {
+        for (int dy = -SHIP_GAP; dy <= SHIP_GAP; dy++) {
+            for (int dx = -SHIP_GAP; dx <= SHIP_GAP; dx++) {
+                int cx = cells[i][0] + dx, cy = cells[i][1] + dy;
+                if (cx < 0 || cy < 0 || cx >= b->width || cy >= b->height || !board_get(b, cx, cy)) {
+                    continue;
+                }
+                bool seen = false;
+                for (int k = 0; k < n && !seen; k++) {
+                    seen = cells[k][0] == cx && cells[k][1] == cy;
+                }
+                if (seen) {
+                    continue;
+                }
+                if (n == SHIP_CELLS) {
+                    return ship_fail(s, x0 - SHIP_GAP, y0 - SHIP_GAP, x1 + SHIP_GAP, y1 + SHIP_GAP);
+                }
+                cells[n][0] = cx;
+                cells[n][1] = cy;
+                n++;
+                x0 = (cx < x0) ? cx : x0;
+                x1 = (cx > x1) ? cx : x1;
+                y0 = (cy < y0) ? cy : y0;
+                y1 = (cy > y1) ? cy : y1;
+            }
+        }
+    }
+    if (x1 - x0 >= 64 || y1 - y0 >= 64) {
+        return ship_fail(s, x0, y0, x1, y1);
+    }
+    Shape shape = { x1 - x0 + 1, y1 - y0 + 1, x0, y0, n, { 0 } };
+    for (int i = 0; i < n; i++) {
+        shape.rows[cells[i][1] - y0] |= 1ULL << (cells[i][0] - x0);
+    }
+
+    // it has to be heading for an edge it is at
+    int dx, dy, pops[SHIP_MAX_PERIOD];
+    int p = ship_period(s, rule, &shape, &dx, &dy, pops);
+    bool out = (dx < 0 && x0 < 2) || (dx > 0 && x1 >= b->width - 2)
+            || (dy < 0 && y0 < 2) || (dy > 0 && y1 >= b->height - 2);
+    if (!p || !out) {
+        return ship_fail(s, x0, y0, x1, y1);
+    }
+    bool steady = true;
+    for (int i = 1; i < p; i++) {
+        steady = steady && pops[i] == pops[0];
+    }
+    if (!steady && s->track_count == s->track_capacity) {
+        int capacity = s->track_capacity ? s->track_capacity * 2 : 16;
+        ShipTrack *tracks = (ShipTrack*) realloc(s->tracks, capacity * sizeof(ShipTrack));
+        if (!tracks) {
+            return false;  // it just stays on the board
+        }
+        s->tracks = tracks;
+        s->track_capacity = capacity;
+    }
+    if (steady) {
+        s->steady += pops[0];
+    } else {
+        ShipTrack *t = &s->tracks[s->track_count++];
+        t->period = p;
+        t->start = g;
+        memcpy(t->pops, pops, sizeof(pops));
+    }
+    if (census) {
+        Board a, tmp;
+        char code[SEARCH_CODE];
+        ship_place(s, &shape, &a, &tmp);
+        search_classify(rule, &a, &tmp, SHIP_MAX_PERIOD, code);
+        census_add(census, code, 1);
+    }
+    for (int i = 0; i < n; i++) {
+        board_set(b, cells[i][0], cells[i][1], false);
+    }
+    s->count++;
+    return true;
+}
+
+/**
+* @brief removes the spaceships leaving a board
+* @param g the generation of the board
+* @param census counts the ships removed if not NULL
+* @return false if live cells other than escaping ships are left within two cells of the edge
+*/
+bool ships_cull(Ships *s, const Rule *rule, Board *b, long g, Census *census) {
+    if (g - s->failed_gen >= SHIP_RECHECK) {
+        s->failed_count = 0;
+        s->failed_gen = g;
+    }
+    bool clear = true;
+    for (int y = 0; y < b->height; y++) {
+        if (y >= 2 && y < b->height - 2) {
+            int xs[4] = { 0, 1, b->width - 2, b->width - 1 };
+            for (int i = 0; i < 4; i++) {
+                if (board_get(b, xs[i], y) && !ship_escape(s, rule, b, xs[i], y, g, census)) {
+                    clear = false;
+                }
+            }
+            continue;
+        }
+        const uint64_t *row = board_row(b, y);
+        for (int w = 0; w < b->words; w++) {
+            for (uint64_t v = row[w]; v; v &= v - 1) {
+                // a ship removed earlier in the scan takes other cells of the row with it
+                int x = (w*64) + __builtin_ctzll(v);
+                if (board_get(b, x, y) && !ship_escape(s, rule, b, x, y, g, census)) {
+                    clear = false;
+                }
+            }
+        }
+    }
+    return clear;
+}
+
+typedef struct {
+    Board a, b;   // the soup
+    Board c, d;   // one object at a time
+    Census census;
+    Ships ships;
+    int *labels;  // SEARCH_SIZE * SEARCH_SIZE, 0 for unvisited
+    int *stack;
+    long objects;
+} SearchTask;
+
+Rule search_rule;
+const char *search_file;
+long search_soups;
+Census search_census;
+SearchTask search_tasks[MAX_THREADS * 4];
+int search_task_count;
+Board search_last;  // the final state of the last soup, for the TUI
+
+/**
+* @brief runs a soup until its population has been periodic for a while
+* @param ships removes the spaceships reaching the edge, reset first
+* @param census counts the spaceships removed
+* @return the generations run
+*/
+int search_run(const Rule *rule, Board *a, Board *b, Ships *ships, Census *census) {
+    int pops[SEARCH_MAX_GEN + 1];
+    int y0, y1;
+    board_used_rows(a, &y0, &y1);
+    ships_reset(ships);
+    bool near = board_near_edge(a);
+    for (int g = 0; g < SEARCH_MAX_GEN; g++) {
+        if (near) {
+            ships_cull(ships, rule, a, g, census);
+        }
+        // only rows near live cells are stepped, the range only grows so the rows
+        // outside it stay empty in both boards
+        y0 = (y0 > 0) ? y0-1 : 0;
+        y1 = (y1 < a->height) ? y1+1 : a->height;
+        board_step_rows(rule, a, b, y0, y1, NULL);
+        Board t = *a;
+        *a = *b;
+        *b = t;
+
+        // the edge is checked on the way, as board_near_edge does
+        int pop = 0;
+        near = false;
+        for (int y = y0; y < y1; y++) {
+            const uint64_t *row = board_row(a, y);
+            int row_pop = 0;
+            for (int w = 0; w < a->words; w++) {
+                row_pop += __builtin_popcountll(row[w]);
+            }
+            pop += row_pop;
+            near = near || (row_pop && (y < 2 || y >= a->height - 2))
+                        || (row[0] & 3ULL) || (row[a->words-1] & (3ULL << 62));
+        }
+        pops[g] = pop + (int) ships_pop(ships, g+1);
+        if (g % 16 == 15 && pops_periodic(pops, g, SEARCH_MAX_PERIOD / 2)) {
+            return g+1;
+        }
+    }
+    return SEARCH_MAX_GEN;
+}
+
+/**
+* @brief splits the final board of a soup into objects and counts them
+*
+* Each object is flood filled over cells at most two apart, copied onto a clean board
+* with room to move and classified on its own.
+*/
+void search_objects(SearchTask *t) {
+    Board *a = &t->a;
+    size_t bytes = (size_t) (t->c.height + 2) * t->c.words * sizeof(uint64_t);
+    memset(t->labels, 0, SEARCH_SIZE * SEARCH_SIZE * sizeof(int));
+    for (int y = 0; y < a->height; y++) {
+        for (int x = 0; x < a->width; x++) {
+            if (!board_get(a, x, y) || t->labels[(y * SEARCH_SIZE) + x]) {
+                continue;
+            }
+            memset(t->c.data, 0, bytes);
+            memset(t->d.data, 0, bytes);
+            int sp = 0;
+            t->stack[sp++] = (y * SEARCH_SIZE) + x;
+            t->labels[(y * SEARCH_SIZE) + x] = 1;
+            bool fits = true;
+            int ox = (SEARCH_SIZE / 2) - x, oy = (SEARCH_SIZE / 2) - y;
+            while (sp > 0) {
+                int cell = t->stack[--sp];
+                int cx = cell % SEARCH_SIZE, cy = cell / SEARCH_SIZE;
+                int bx = cx + ox, by = cy + oy;
+                if (bx < SEARCH_MAX_PERIOD || bx >= SEARCH_SIZE - SEARCH_MAX_PERIOD
+                    || by < SEARCH_MAX_PERIOD || by >= SEARCH_SIZE - SEARCH_MAX_PERIOD) {
+                    fits = false;
+                }
+                board_set(&t->c, bx, by, true);
+                for (int dy = -2; dy <= 2; dy++) {
+                    for (int dx = -2; dx <= 2; dx++) {
+                        int nx = cx + dx, ny = cy + dy;
+                        if (nx < 0 || ny < 0 || nx >= a->width || ny >= a->height
+                            || t->labels[(ny * SEARCH_SIZE) + nx] || !board_get(a, nx, ny)) {
+                            continue;
+                        }
+                        t->labels[(ny * SEARCH_SIZE) + nx] = 1;
+                        t->stack[sp++] = (ny * SEARCH_SIZE) + nx;
+                    }
+                }
+            }
+            char code[SEARCH_CODE];
+            if (fits) {
+                search_classify(&search_rule, &t->c, &t->d, SEARCH_MAX_PERIOD, code);
+            } else {
+                strcpy(code, "zz_LARGE");
+            }
+            census_add(&t->census, code, 1);
+            t->objects++;
+        }
+    }
+}
+
+/**
+* @brief runs SEARCH_TASK soups on one task's boards
+*/
+void search_task(int task, void *arg) {
+    SearchTask *t = &search_tasks[task];
+    long first = *(long*) arg + ((long) task * SEARCH_TASK);
+    size_t bytes = (size_t) (t->a.height + 2) * t->a.words * sizeof(uint64_t);
+    for (long i = first; i < first + SEARCH_TASK; i++) {
+        // every soup has its own seed, so soup i is the same whatever ran before it
+        Soup s = soup;
+        s.seed = soup.seed + ((uint64_t) i * 0x9E3779B97F4A7C15ULL);
+        memset(t->a.data, 0, bytes);
+        memset(t->b.data, 0, bytes);
+        int o = (SEARCH_SIZE - SEARCH_SOUP) / 2;
+        soup_fill(&t->a, &s, o, o, SEARCH_SOUP, SEARCH_SOUP);
+        search_run(&search_rule, &t->a, &t->b, &t->ships, &t->census);
+        search_objects(t);
+    }
+}
+
+/**
+* @brief sets up a board, a census and scratch space per task
+* @return true if the rule was valid and memory was allocated
+*/
+bool search_init(int argc, char **argv) {
+    if (!parse_rule((argc > 0) ? argv[0] : "B3/S23", &search_rule)) {
+        return false;
+    }
+    search_file = (argc > 1) ? argv[1] : "census.txt";
+    search_soups = 0;
+    search_task_count = thread_count * 4;
+    if (!board_init(&search_last, SEARCH_SIZE, SEARCH_SIZE)) {
+        return false;
+    }
+    for (int i = 0; i < search_task_count; i++) {
+        SearchTask *t = &search_tasks[i];
+        t->labels = (int*) malloc(SEARCH_SIZE * SEARCH_SIZE * sizeof(int));
+        t->stack = (int*) malloc(SEARCH_SIZE * SEARCH_SIZE * sizeof(int));
+        if (!t->labels || !t->stack
+            || !board_init(&t->a, SEARCH_SIZE, SEARCH_SIZE) || !board_init(&t->b, SEARCH_SIZE, SEARCH_SIZE)
+            || !board_init(&t->c, SEARCH_SIZE, SEARCH_SIZE) || !board_init(&t->d, SEARCH_SIZE, SEARCH_SIZE)
+            || !ships_init(&t->ships)) {
+            fprintf(stderr, "Error allocating memory for the soup search\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief searches one batch of soups and merges the census of every task
+*/
+void search_step() {
+    long first = search_soups;
+    run_parallel(search_task_count, search_task, &first);
+    for (int i = 0; i < search_task_count; i++) {
+        Census *c = &search_tasks[i].census;
+        for (size_t e = 0; e < c->size; e++) {
+            if (c->entries[e].count && !census_add(&search_census, c->entries[e].code, c->entries[e].count)) {
+                exit(1);
+            }
+        }
+        census_clear(c);
+    }
+    search_soups += (long) search_task_count * SEARCH_TASK;
+    Board *a = &search_tasks[search_task_count - 1].a;
+    memcpy(search_last.data, a->data, (size_t) (a->height + 2) * a->words * sizeof(uint64_t));
+}
+
+void search_draw(Screen *scr) {
+    board_draw(&search_last, search_rule.neighborhood, scr);
+}
+
+int census_compare(const void *a, const void *b) {
+    const CensusEntry *x = (const CensusEntry*) a, *y = (const CensusEntry*) b;
+    if (x->count != y->count) {
+        return (x->count < y->count) ? 1 : -1;
+    }
+    return strcmp(x->code, y->code);
+}
+
+/**
+* @brief sorts the census, most common objects first, empty entries last
+*/
+void census_sort(Census *c) {
+    if (c->entries) {
+        qsort(c->entries, c->size, sizeof(CensusEntry), census_compare);
+    }
+}
+
+/**
+* @brief prints the most common objects after a headless run
+*/
+void search_report() {
+    census_sort(&search_census);
+    printf("%ld soups, %zu distinct objects\n", search_soups, search_census.used);
+    for (size_t i = 0; i < search_census.used && i < 10; i++) {
+        printf("%10ld %s\n", search_census.entries[i].count, search_census.entries[i].code);
+    }
+}
+
+/**
+* @brief writes the census to the results file and frees everything
+*/
+void search_destroy() {
+    census_sort(&search_census);
+    FILE *f = fopen(search_file, "w");
+    if (!f) {
+        fprintf(stderr, "[E] Could not write %s\n", search_file);
+    } else {
+        fprintf(f, "# %ld soups, rule B", search_soups);
+        for (int i = 0; i <= 8; i++) {
+            if ((search_rule.birth >> i) & 1) {
+                fprintf(f, "%d", i);
+            }
+        }
+        fprintf(f, "/S");
+        for (int i = 0; i <= 8; i++) {
+            if ((search_rule.survive >> i) & 1) {
+                fprintf(f, "%d", i);
+            }
+        }
+        fprintf(f, "\n");
+        for (size_t i = 0; i < search_census.used; i++) {
+            fprintf(f, "%ld %s\n", search_census.entries[i].count, search_census.entries[i].code);
+        }
+        fclose(f);
+    }
+    census_clear(&search_census);
+    for (int i = 0; i < search_task_count; i++) {
+        SearchTask *t = &search_tasks[i];
+        free(t->labels);
+        free(t->stack);
+        board_destroy(&t->a);
+        board_destroy(&t->b);
+        board_destroy(&t->c);
+        board_destroy(&t->d);
+        ships_destroy(&t->ships);
+        census_clear(&t->census);
+    }
+    board_destroy(&search_last);
+}
+
+/*
+* Methuselah search. Small seeds inside a WxH box, random or every pattern in turn,
+* are run to stabilization on a board that doubles whenever the pattern comes within
+* two cells of its edge, unless all that got there were escaping spaceships, which
+* are removed instead, and the longest lived are kept on a leaderboard. Runs stop
+* early when the population turns periodic, dies out, passes METH_MAX_GEN or the
+* board would pass METH_MAX_SIZE. The next seed and the leaderboard are checkpointed
+* after every step, and a search with the same settings resumes from the checkpoint.
+*
+* Arguments: [rule] [WxH] [random|enum] [checkpoint]. Enumerated seeds must touch the
+* top and left of the box, the others are translations of seeds already run.
+*/
+#define METH_MAX_GEN   50000
+#define METH_MAX_SIZE  4096
+#define METH_TOP       10   // leaderboard size
+#define METH_TASK      8    // seeds per task
+
+typedef struct {
+    long lifespan;  // generations until the population turned periodic
+    long pop;       // final population, with the ships removed
+    uint64_t seed;  // seed index, the pattern is rebuilt from it
+    int ships;      // escaping spaceships removed on the way
+} MethEntry;
+
+typedef struct {
+    Board a, b;
+    Ships ships;
+    int *pops;
+    MethEntry top[METH_TOP];
+} MethTask;
+
+Rule meth_rule;
+const char *meth_rule_name;
+const char *meth_file;
+int meth_w, meth_h;
+bool meth_enum;
+uint64_t meth_next;  // next seed index
+MethEntry meth_top[METH_TOP];
+MethTask meth_tasks[MAX_THREADS * 4];
+int meth_task_count;
+
+/**
+* @brief puts a result on a leaderboard if it makes it, longest lifespan first and
+* then largest final population
+*/
+void meth_rank(MethEntry *top, const MethEntry *e) {
+    int i = METH_TOP;
+    while (i > 0 && (top[i-1].lifespan < e->lifespan
+                     || (top[i-1].lifespan == e->lifespan && top[i-1].pop < e->pop))) {
+        i--;
+    }
+    if (i == METH_TOP) {
+        return;
+    }
+    memmove(&top[i+1], &top[i], (METH_TOP - i - 1) * sizeof(MethEntry));
+    top[i] = *e;
+}
+
+/**
+* @brief draws seed i into the box at (x, y) of a board
+* @return false if an enumerated seed is a translation of another one
+*/
+bool meth_seed(Board *b, uint64_t i, int x, int y) {
+    if (!meth_enum) {
+        Soup s = soup;
+        s.seed = soup.seed + (i * 0x9E3779B97F4A7C15ULL);
+        return soup_fill(b, &s, x, y, meth_w, meth_h);
+    }
+    uint64_t rows = 0, cols = 0;
+    for (int k = 0; k < meth_w * meth_h; k++) {
+        if ((i >> k) & 1) {
+            board_set(b, x + (k % meth_w), y + (k / meth_w), true);
+            rows |= 1ULL << (k / meth_w);
+            cols |= 1ULL << (k % meth_w);
+        }
+    }
+    return (rows & 1) && (cols & 1);
+}
+
+/**
+* @brief doubles a board around its pattern
+* @return false past METH_MAX_SIZE or if memory ran out
+*/
+bool meth_grow(Board *a, Board *b) {
+    if (a->width * 2 > METH_MAX_SIZE) {
+        return false;
+    }
+    Board big, spare;
+    if (!board_init(&big, a->width * 2, a->height * 2)) {
+        return false;
+    }
+    if (!board_init(&spare, a->width * 2, a->height * 2)) {
+        board_destroy(&big);
+        return false;
+    }
+    // widths stay multiples of 128, so the pattern moves by whole words
+    int dw = a->words / 2, dy = a->height / 2;
+    for (int y = 0; y < a->height; y++) {
+        memcpy(&board_row(&big, y + dy)[dw], board_row(a, y), a->words * sizeof(uint64_t));
+    }
+    board_destroy(a);
+    board_destroy(b);
+    *a = big;
+    *b = spare;
+    return true;
+}
+
+/**
+* @brief runs one seed to stabilization
+* @param t the task, its boards are grown as needed and freed afterwards
+* @param i the seed index
+* @param e receives the result
+* @return false if the seed was skipped
+*/
+bool meth_run(MethTask *t, uint64_t i, MethEntry *e) {
+    if (!board_init(&t->a, 128, 128) || !board_init(&t->b, 128, 128)) {
+        return false;
+    }
+    bool ok = meth_seed(&t->a, i, 64 - (meth_w / 2), 64 - (meth_h / 2));
+    e->seed = i;
+    e->lifespan = METH_MAX_GEN;
+    e->pop = 0;
+    e->ships = 0;
+    ships_reset(&t->ships);
+    for (int g = 0; ok && g < METH_MAX_GEN; g++) {
+        if (board_near_edge(&t->a) && !ships_cull(&t->ships, &meth_rule, &t->a, g, NULL)
+            && !meth_grow(&t->a, &t->b)) {
+            e->lifespan = g;  // cut off, it is still running
+            break;
+        }
+        board_step(&meth_rule, &t->a, &t->b);
+        Board s = t->a;
+        t->a = t->b;
+        t->b = s;
+
+        int pop = 0;
+        for (int y = 0; y < t->a.height; y++) {
+            const uint64_t *row = board_row(&t->a, y);
+            for (int w = 0; w < t->a.words; w++) {
+                pop += __builtin_popcountll(row[w]);
+            }
+        }
+        pop += (int) ships_pop(&t->ships, g+1);
+        t->pops[g] = pop;
+        e->pop = pop;
+        e->ships = t->ships.count;
+        if (pop == 0) {
+            e->lifespan = g+1;
+            break;
+        }
+        int p = (g % 16 == 15) ? pops_periodic(t->pops, g, SEARCH_MAX_PERIOD / 2) : 0;
+        if (p > 0) {
+            // the population settled some while before it was noticed, pops[g] is generation g+1
+            int start = g;
+            while (start - p >= 0 && t->pops[start] == t->pops[start-p]) {
+                start--;
+            }
+            e->lifespan = start - p + 2;
+            break;
+        }
+    }
+    board_destroy(&t->a);
+    board_destroy(&t->b);
+    return ok;
+}
+
+/**
+* @brief runs METH_TASK seeds into the task's own leaderboard
+*/
+void meth_task(int task, void *arg) {
+    MethTask *t = &meth_tasks[task];
+    uint64_t first = *(uint64_t*) arg + ((uint64_t) task * METH_TASK);
+    uint64_t end = meth_enum ? 1ULL << (meth_w * meth_h) : UINT64_MAX;
+    for (uint64_t i = first; i < first + METH_TASK && i < end; i++) {
+        MethEntry e;
+        if (meth_run(t, i, &e)) {
+            meth_rank(t->top, &e);
+        }
+    }
+}
+
+/**
+* @brief writes the settings a checkpoint belongs to, random seeds also depend on the
+* density and symmetry of the soup
+*/
+void meth_header(char *buf, size_t size) {
+    int n = snprintf(buf, size, "methuselah %s %dx%d %s %llu", meth_rule_name, meth_w, meth_h,
+                     meth_enum ? "enum" : "random", (unsigned long long) soup.seed);
+    if (!meth_enum && n > 0 && (size_t) n < size) {
+        snprintf(buf + n, size - n, " %u %c%d", soup.density,
+                 (soup.symmetry == SYMMETRY_D8) ? 'D' : 'C', soup.symmetry);
+    }
+}
+
+/**
+* @brief writes the next seed and the leaderboard, through a temporary file so an
+* interrupted write leaves the old checkpoint in place
+*/
+void meth_checkpoint() {
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", meth_file);
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        fprintf(stderr, "[E] Could not write %s\n", tmp);
+        return;
+    }
+    char header[256];
+    meth_header(header, sizeof(header));
+    fprintf(f, "%s\n", header);
+    fprintf(f, "next %llu\n", (unsigned long long) meth_next);
+    for (int i = 0; i < METH_TOP && meth_top[i].lifespan > 0; i++) {
+        fprintf(f, "%ld %ld %llu %d\n", meth_top[i].lifespan, meth_top[i].pop,
+                (unsigned long long) meth_top[i].seed, meth_top[i].ships);
+    }
+    fclose(f);
+    if (rename(tmp, meth_file) != 0) {
+        fprintf(stderr, "[E] Could not replace %s\n", meth_file);
+    }
+}
+
+/**
+* @brief resumes from the checkpoint, if there is one
+* @return false if it was written by a search with other settings, which would
+* otherwise be overwritten
+*/
+bool meth_resume() {
+    FILE *f = fopen(meth_file, "r");
+    if (!f) {
+        return true;
+    }
+    char header[256], expect[256];
+    meth_header(expect, sizeof(expect));
+    unsigned long long next, seed;
+    if (!fgets(header, sizeof(header), f) || strcspn(header, "\n") != strlen(expect)
+        || strncmp(header, expect, strlen(expect)) != 0 || fscanf(f, "next %llu", &next) != 1) {
+        fprintf(stderr, "[E] %s belongs to another search, give another checkpoint file\n", meth_file);
+        fclose(f);
+        return false;
+    }
+    meth_next = next;
+    // checkpoints from before ships were removed have no ship count
+    MethEntry e;
+    char line[256];
+    fgets(line, sizeof(line), f);
+    while (fgets(line, sizeof(line), f)) {
+        e.ships = 0;
+        if (sscanf(line, "%ld %ld %llu %d", &e.lifespan, &e.pop, &seed, &e.ships) < 3) {
+            break;
+        }
+        e.seed = seed;
+        meth_rank(meth_top, &e);
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+* @brief parses the search settings and resumes from the checkpoint
+* @return true if the arguments were valid
+*/
+bool meth_init(int argc, char **argv) {
+    meth_rule_name = (argc > 0) ? argv[0] : "B3/S23";
+    if (!parse_rule(meth_rule_name, &meth_rule)) {
+        return false;
+    }
+    meth_w = 5;
+    meth_h = 5;
+    if (argc > 1 && (sscanf(argv[1], "%dx%d", &meth_w, &meth_h) != 2
+                     || meth_w < 1 || meth_h < 1 || meth_w > 32 || meth_h > 32)) {
+        fprintf(stderr, "[E] Invalid box: %s\n", argv[1]);
+        return false;
+    }
+    meth_enum = argc > 2 && strcmp(argv[2], "enum") == 0;
+    if (!meth_enum && (soup.symmetry == SYMMETRY_C4 || soup.symmetry == SYMMETRY_D8) && meth_w != meth_h) {
+        fprintf(stderr, "[E] C4 and D8 seeds need a square box, got %dx%d\n", meth_w, meth_h);
+        return false;
+    }
+    if (meth_enum && meth_w * meth_h > 40) {
+        fprintf(stderr, "[E] Boxes of more than 40 cells cannot be enumerated\n");
+        return false;
+    }
+    meth_file = (argc > 3) ? argv[3] : "methuselah.ckpt";
+    meth_next = meth_enum ? 1 : 0;
+    memset(meth_top, 0, sizeof(meth_top));
+    if (!meth_resume()) {
+        return false;
+    }
+
+    meth_task_count = thread_count * 4;
+    for (int i = 0; i < meth_task_count; i++) {
+        meth_tasks[i].pops = (int*) malloc(METH_MAX_GEN * sizeof(int));
+        if (!meth_tasks[i].pops || !ships_init(&meth_tasks[i].ships)) {
+            fprintf(stderr, "Error allocating memory for the methuselah search\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief runs a batch of seeds, merges the leaderboards and writes the checkpoint
+*/
+void meth_step() {
+    uint64_t end = meth_enum ? 1ULL << (meth_w * meth_h) : UINT64_MAX;
+    if (meth_next >= end) {
+        return;
+    }
+    uint64_t first = meth_next;
+    run_parallel(meth_task_count, meth_task, &first);
+    for (int i = 0; i < meth_task_count; i++) {
+        for (int k = 0; k < METH_TOP && meth_tasks[i].top[k].lifespan > 0; k++) {
+            meth_rank(meth_top, &meth_tasks[i].top[k]);
+        }
+        memset(meth_tasks[i].top, 0, sizeof(meth_tasks[i].top));
+    }
+    uint64_t done = (uint64_t) meth_task_count * METH_TASK;
+    meth_next = (end - meth_next > done) ? meth_next + done : end;
+    meth_checkpoint();
+}
+
+/**
+* @brief draws the leader's seed in the middle of the screen
+*/
+void meth_draw(Screen *scr) {
+    Board b;
+    if (!board_init(&b, scr->width, scr->height)) {
+        return;
+    }
+    if (meth_top[0].lifespan > 0) {
+        meth_seed(&b, meth_top[0].seed, (scr->width - meth_w) / 2, (scr->height - meth_h) / 2);
+    }
+    board_draw(&b, meth_rule.neighborhood, scr);
+    board_destroy(&b);
+}
+
+/**
+* @brief prints the leaderboard, each seed as rows of its box
+*/
+void meth_report() {
+    printf("next seed %llu\n", (unsigned long long) meth_next);
+    Board b;
+    if (!board_init(&b, meth_w, meth_h)) {
+        return;
+    }
+    for (int i = 0; i < METH_TOP && meth_top[i].lifespan > 0; i++) {
+        memset(b.data, 0, (size_t) (b.height + 2) * b.words * sizeof(uint64_t));
+        meth_seed(&b, meth_top[i].seed, 0, 0);
+        printf("%2d lifespan %ld population %ld ships %d seed %llu ", i+1, meth_top[i].lifespan,
+               meth_top[i].pop, meth_top[i].ships, (unsigned long long) meth_top[i].seed);
+        for (int y = 0; y < meth_h; y++) {
+            for (int x = 0; x < meth_w; x++) {
+                putchar(board_get(&b, x, y) ? 'o' : '.');
+            }
+            putchar((y < meth_h-1) ? '/' : '\n');
+        }
+    }
+    board_destroy(&b);
+}
+
+void meth_destroy() {
+    for (int i = 0; i < meth_task_count; i++) {
+        free(meth_tasks[i].pops);
+        meth_tasks[i].pops = NULL;
+        ships_destroy(&meth_tasks[i].ships);
+    }
+}
+
+/*
+* Rule space exploration. Every rule of a list, or all 2^18 outer totalistic Moore
+* rules, runs the same RULES_SEEDS soups for up to RULES_GENS generations on a small
+* board, stopping early when a soup dies, turns periodic or reaches the edge. Each rule
+* gets a fixed size RuleRecord in a binary table, written when the engine is destroyed.
+*
+* Arguments: explore [all|rules.txt] [rules.bin] runs the exploration, a step per
+* batch of rules, and browse [rules.bin] previews the rules of a table in the TUI:
+* , and . pick the previous and next rule, c cycles which class is shown, r restarts.
+*/
+#define RULES_SIZE   64  // one word per row
+#define RULES_SOUP   16
+#define RULES_SEEDS  4
+#define RULES_GENS   256
+#define RULES_CURVE  16
+#define RULES_TASK   64  // rules per task
+#define RULES_MAGIC  "GOLRULES"
+
+#define RULE_DIES       0
+#define RULE_STABLE     1
+#define RULE_CHAOTIC    2
+#define RULE_EXPLOSIVE  3
+
+typedef struct {
+    uint16_t birth;
+    uint16_t survive;
+    char neighborhood;
+    uint8_t cls;          // one of the RULE_ classes, the most active over the seeds
+    uint8_t period;       // period of the first periodic seed, 0 if none was
+    uint8_t reserved;
+    float growth;         // mean final population over mean starting population
+    uint16_t curve[RULES_CURVE];  // mean population at evenly spaced generations
+} RuleRecord;
+
+typedef struct {
+    char magic[8];
+    uint32_t count;
+    uint32_t gens;
+    uint32_t seeds;
+    uint32_t record_size;
+} RuleTableHeader;
+
+typedef struct {
+    Board a, b;
+    int pops[RULES_GENS];
+} RulesTask;
+
+bool rules_browse;
+const char *rules_file;
+RuleRecord *rules_table;
+uint32_t rules_count;
+uint32_t rules_done;
+RulesTask rules_tasks[MAX_THREADS * 4];
+int rules_task_count;
+uint32_t rules_selected;
+int rules_filter;        // class shown in the browser, -1 for every class
+Board rules_preview[2];
+
+/**
+* @brief runs the fixed soups under one rule and fills in its record
+*/
+void rules_eval(RulesTask *t, RuleRecord *rec) {
+    Rule rule = { rec->birth, rec->survive, rec->neighborhood };
+    size_t bytes = (size_t) (t->a.height + 2) * t->a.words * sizeof(uint64_t);
+    double start_pop = 0, final_pop = 0;
+    uint32_t curve[RULES_CURVE] = { 0 };
+    rec->cls = RULE_DIES;
+    rec->period = 0;
+    for (int s = 0; s < RULES_SEEDS; s++) {
+        // the same soups for every rule, independent of -d and -Y
+        Soup seed = { CHANCE_ONE / 2, soup.seed + ((uint64_t) s * 0x9E3779B97F4A7C15ULL), SYMMETRY_C1 };
+        memset(t->a.data, 0, bytes);
+        memset(t->b.data, 0, bytes);
+        soup_fill(&t->a, &seed, (RULES_SIZE - RULES_SOUP) / 2, (RULES_SIZE - RULES_SOUP) / 2,
+                  RULES_SOUP, RULES_SOUP);
+
+        int cls = RULE_CHAOTIC;
+        int pop = 0;
+        for (int y = 0; y < t->a.height; y++) {
+            pop += __builtin_popcountll(board_row(&t->a, y)[0]);
+        }
+        start_pop += pop;
+        int g = 0, samples = 0;
+        for (; g < RULES_GENS; g++) {
+            // gliders reach the edge too, only growth that gets there counts as explosive
+            if (pop > 2 * RULES_SOUP * RULES_SOUP / 2 && board_near_edge(&t->a)) {
+                cls = RULE_EXPLOSIVE;
+                break;
+            }
+            board_step(&rule, &t->a, &t->b);
+            Board tmp = t->a;
+            t->a = t->b;
+            t->b = tmp;
+
+            pop = 0;
+            for (int y = 0; y < t->a.height; y++) {
+                pop += __builtin_popcountll(board_row(&t->a, y)[0]);
+            }
+            t->pops[g] = pop;
+            if (g % (RULES_GENS / RULES_CURVE) == (RULES_GENS / RULES_CURVE) - 1) {
+                curve[samples++] += pop;
+            }
+            if (pop == 0) {
+                cls = RULE_DIES;
+                break;
+            }
+            int p = (g % 16 == 15) ? pops_periodic(t->pops, g, SEARCH_MAX_PERIOD / 2) : 0;
+            if (p > 0) {
+                cls = RULE_STABLE;
+                rec->period = rec->period ? rec->period : p;
+                break;
+            }
+        }
+        // a soup that stopped early keeps its last population for the rest of the curve
+        for (; samples < RULES_CURVE; samples++) {
+            curve[samples] += pop;
+        }
+        final_pop += pop;
+        rec->cls = (cls > rec->cls) ? cls : rec->cls;
+    }
+    rec->growth = (start_pop > 0) ? (float) (final_pop / start_pop) : 0;
+    for (int k = 0; k < RULES_CURVE; k++) {
+        rec->curve[k] = (uint16_t) (curve[k] / RULES_SEEDS);
+    }
+}
+
+/**
+* @brief evaluates RULES_TASK rules of the table
+*/
+void rules_task(int task, void *arg) {
+    RulesTask *t = &rules_tasks[task];
+    uint32_t first = *(uint32_t*) arg + ((uint32_t) task * RULES_TASK);
+    for (uint32_t i = first; i < first + RULES_TASK && i < rules_count; i++) {
+        rules_eval(t, &rules_table[i]);
+    }
+}
+
+/**
+* @brief adds a rule to the table, growing it as needed
+*/
+bool rules_add(const Rule *rule, uint32_t *capacity) {
+    if (rules_count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 1024;
+        RuleRecord *bigger = (RuleRecord*) realloc(rules_table, *capacity * sizeof(RuleRecord));
+        if (!bigger) {
+            fprintf(stderr, "Error allocating memory for the rule table\n");
+            return false;
+        }
+        rules_table = bigger;
+    }
+    RuleRecord *rec = &rules_table[rules_count++];
+    memset(rec, 0, sizeof(RuleRecord));
+    rec->birth = rule->birth;
+    rec->survive = rule->survive;
+    rec->neighborhood = rule->neighborhood;
+    return true;
+}
+
+/**
+* @brief reads a table written by an exploration
+*/
+bool rules_load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[E] Could not open %s\n", path);
+        return false;
+    }
+    RuleTableHeader h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, RULES_MAGIC, 8) != 0
+        || h.record_size != sizeof(RuleRecord) || h.count == 0) {
+        fprintf(stderr, "[E] %s is not a rule table\n", path);
+        fclose(f);
+        return false;
+    }
+    rules_table = (RuleRecord*) malloc(h.count * sizeof(RuleRecord));
+    if (!rules_table || fread(rules_table, sizeof(RuleRecord), h.count, f) != h.count) {
+        fprintf(stderr, "[E] Could not read %s\n", path);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    rules_count = h.count;
+    rules_done = h.count;
+    return true;
+}
+
+/**
+* @brief restarts the preview board with the selected rule
+*/
+void rules_restart() {
+    memset(rules_preview[0].data, 0,
+           (size_t) (rules_preview[0].height + 2) * rules_preview[0].words * sizeof(uint64_t));
+    soup_fill(&rules_preview[0], &soup, (board_width / 2) - 16, (board_height / 2) - 16, 32, 32);
+}
+
+/**
+* @brief sets up an exploration or loads a table to browse
+* @return true if the arguments were valid
+*/
+bool rules_init(int argc, char **argv) {
+    rules_table = NULL;
+    rules_count = 0;
+    rules_done = 0;
+    rules_browse = argc > 0 && strcmp(argv[0], "browse") == 0;
+    if (rules_browse) {
+        rules_file = (argc > 1) ? argv[1] : "rules.bin";
+        if (!rules_load(rules_file)
+            || !board_init(&rules_preview[0], board_width, board_height)
+            || !board_init(&rules_preview[1], board_width, board_height)) {
+            return false;
+        }
+        rules_selected = 0;
+        rules_filter = -1;
+        rules_restart();
+        return true;
+    }
+    if (argc > 0 && strcmp(argv[0], "explore") != 0) {
+        fprintf(stderr, "[E] Unknown mode: %s\n", argv[0]);
+        return false;
+    }
+
+    const char *source = (argc > 1) ? argv[1] : "all";
+    rules_file = (argc > 2) ? argv[2] : "rules.bin";
+    uint32_t capacity = 0;
+    if (strcmp(source, "all") == 0) {
+        for (uint32_t bits = 0; bits < (1u << 18); bits++) {
+            Rule rule = { (uint16_t) (bits & 0x1FF), (uint16_t) (bits >> 9), NEIGHBORHOOD_MOORE };
+            if (!rules_add(&rule, &capacity)) {
+                return false;
+            }
+        }
+    } else {
+        FILE *f = fopen(source, "r");
+        if (!f) {
+            fprintf(stderr, "[E] Could not open %s\n", source);
+            return false;
+        }
+        char line[64];
+        while (fgets(line, sizeof(line), f)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            Rule rule;
+            if (line[0] == '\0' || line[0] == '#') {
+                continue;
+            }
+            if (!parse_rule(line, &rule) || !rules_add(&rule, &capacity)) {
+                fclose(f);
+                return false;
+            }
+        }
+        fclose(f);
+    }
+
+    rules_task_count = thread_count * 4;
+    for (int i = 0; i < rules_task_count; i++) {
+        if (!board_init(&rules_tasks[i].a, RULES_SIZE, RULES_SIZE)
+            || !board_init(&rules_tasks[i].b, RULES_SIZE, RULES_SIZE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief explores the next batch of rules, or advances the preview when browsing
+*/
+void rules_step() {
+    if (rules_browse) {
+        RuleRecord *rec = &rules_table[rules_selected];
+        Rule rule = { rec->birth, rec->survive, rec->neighborhood };
+        board_step(&rule, &rules_preview[0], &rules_preview[1]);
+        Board t = rules_preview[0];
+        rules_preview[0] = rules_preview[1];
+        rules_preview[1] = t;
+        return;
+    }
+    if (rules_done >= rules_count) {
+        return;
+    }
+    uint32_t first = rules_done;
+    run_parallel(rules_task_count, rules_task, &first);
+    uint32_t batch = (uint32_t) rules_task_count * RULES_TASK;
+    rules_done = (rules_count - rules_done > batch) ? rules_done + batch : rules_count;
+}
+
+/**
+* @brief moves through the table in the browser, skipping rules outside the class filter
+*/
+void rules_key(char ch) {
+    if (!rules_browse) {
+        return;
+    }
+    int dir = 0;
+    switch (ch) {
+        case ',': dir = -1; break;
+        case '.': dir = 1; break;
+        case 'c':
+            rules_filter = (rules_filter < RULE_EXPLOSIVE) ? rules_filter + 1 : -1;
+            dir = 1;
+            break;
+        case 'r':
+            rules_restart();
+            return;
+        default:
+            return;
+    }
+    uint32_t i = rules_selected;
+    for (uint32_t n = 0; n < rules_count; n++) {
+        i = (i + rules_count + dir) % rules_count;
+        if (rules_filter < 0 || rules_table[i].cls == rules_filter) {
+            rules_selected = i;
+            rules_restart();
+            return;
+        }
+    }
+}
+
+void rules_draw(Screen *scr) {
+    if (rules_browse) {
+        board_draw(&rules_preview[0], rules_table[rules_selected].neighborhood, scr);
+    }
+}
+
+/**
+* @brief prints how many rules fell into each class
+*/
+void rules_report() {
+    uint32_t counts[4] = { 0 };
+    for (uint32_t i = 0; i < rules_done; i++) {
+        counts[rules_table[i].cls]++;
+    }
+    printf("%u of %u rules: %u die, %u stable, %u chaotic, %u explosive\n", rules_done, rules_count,
+           counts[RULE_DIES], counts[RULE_STABLE], counts[RULE_CHAOTIC], counts[RULE_EXPLOSIVE]);
+}
+
+/**
+* @brief writes the explored rules to the table file and frees everything
+*/
+void rules_destroy() {
+    if (!rules_browse && rules_table) {
+        FILE *f = fopen(rules_file, "wb");
+        RuleTableHeader h = { RULES_MAGIC, rules_done, RULES_GENS, RULES_SEEDS, sizeof(RuleRecord) };
+        if (!f || fwrite(&h, sizeof(h), 1, f) != 1
+            || fwrite(rules_table, sizeof(RuleRecord), rules_done, f) != rules_done) {
+            fprintf(stderr, "[E] Could not write %s\n", rules_file);
+        }
+        if (f) {
+            fclose(f);
+        }
+        for (int i = 0; i < rules_task_count; i++) {
+            board_destroy(&rules_tasks[i].a);
+            board_destroy(&rules_tasks[i].b);
+        }
+    }
+    if (rules_browse) {
+        board_destroy(&rules_preview[0]);
+        board_destroy(&rules_preview[1]);
+    }
+    free(rules_table);
+    rules_table = NULL;
+}
+
+/*
+* Ensembles of small boards for Monte Carlo runs. The boards are transposed so that
+* lane k of every cell belongs to board k, and one pass of the bit-sliced adders
+* steps ENSEMBLE_LANES boards at once, each group of that many boards being a task.
+* Boards wrap around. A board stops being tracked when it dies or settles into
+* period 1 or 2, its population and generation are kept from then on.
+*
+* Arguments: [rule] [boards] [size]
+*/
+#ifndef ENSEMBLE_LANES
+#define ENSEMBLE_LANES  512  // boards per group, a multiple of 64
+#endif
+#define ENSEMBLE_WORDS  (ENSEMBLE_LANES / 64)
+#define ENSEMBLE_MAX    64   // largest side of a board
+#define ENSEMBLE_BITS   13   // bits of the population counters, enough for 64x64
+
+typedef uint64_t Lanes __attribute__((vector_size(ENSEMBLE_LANES / 8)));
+
+typedef struct {
+    Lanes *cells[3];                   // the current generation and the two before it
+    uint64_t running[ENSEMBLE_WORDS];  // boards that have not terminated
+} EnsembleGroup;
+
+typedef struct {
+    int pop;
+    int period;  // 0 if it died, -1 while running
+    long end;    // generation it terminated at
+} EnsembleBoard;
+
+Rule ensemble_rule;
+int ensemble_size;
+int ensemble_boards;
+int ensemble_group_count;
+EnsembleGroup *ensemble_groups;
+EnsembleBoard *ensemble_states;
+long ensemble_gen;
+int ensemble_view;  // first board drawn
+int ensemble_page;  // boards that fit whole on the screen at the last draw
+
+/**
+* @brief applies a rule to bit-sliced neighbor counts of every lane, see rule_apply
+*
+* The vectors go by pointer, passing them by value changes with the instruction set.
+* @param p the bits of the neighbor counts, lowest first
+*/
+static inline void lanes_apply(const Rule *rule, const Lanes *alive, const Lanes p[4], Lanes *next) {
+    Lanes none = { 0 };
+    *next = none;
+    uint16_t counts = rule->birth | rule->survive;
+    for (int n = 0; counts; n++, counts >>= 1) {
+        if (!(counts & 1)) {
+            continue;
+        }
+        Lanes eq = ((n & 1) ? p[0] : ~p[0]) & ((n & 2) ? p[1] : ~p[1])
+                 & ((n & 4) ? p[2] : ~p[2]) & ((n & 8) ? p[3] : ~p[3]);
+        Lanes who = (((rule->birth >> n) & 1) ? ~*alive : none)
+                  | (((rule->survive >> n) & 1) ? *alive : none);
+        *next |= eq & who;
+    }
+}
+
+static inline bool lane_get(const Lanes *v, int k) {
+    return ((*v)[k / 64] >> (k % 64)) & 1;
+}
+
+bool ensemble_cell(int board, int x, int y) {
+    EnsembleGroup *g = &ensemble_groups[board / ENSEMBLE_LANES];
+    return lane_get(&g->cells[0][(y * ensemble_size) + x], board % ENSEMBLE_LANES);
+}
+
+/**
+* @brief steps a group of boards and records the ones that terminate
+*
+* The populations are summed in a 4 bit counter per lane that is added to the wide
+* counter every 15 cells, which keeps the cost per cell close to that of the kernel.
+*/
+void ensemble_task(int task, void *arg) {
+    (void) arg;
+    EnsembleGroup *g = &ensemble_groups[task];
+    uint64_t any = 0;
+    for (int w = 0; w < ENSEMBLE_WORDS; w++) {
+        any |= g->running[w];
+    }
+    if (!any) {
+        return;
+    }
+
+    int n = ensemble_size;
+    char hood = ensemble_rule.neighborhood;
+    Lanes *cur = g->cells[0], *prev = g->cells[1], *next = g->cells[2];
+    Lanes none = { 0 }, moved = { 0 }, moved2 = { 0 };
+    Lanes wide[ENSEMBLE_BITS] = { { 0 } }, small[4] = { { 0 } };
+    int added = 0;
+    for (int y = 0; y < n; y++) {
+        const Lanes *a = &cur[((y+n-1) % n) * n];
+        const Lanes *c = &cur[y * n];
+        const Lanes *b = &cur[((y+1) % n) * n];
+        for (int x = 0; x < n; x++) {
+            int w = (x+n-1) % n, e = (x+1) % n;
+            Lanes nw = a[w], ne = a[e], sw = b[w], se = b[e];
+            if (hood == NEIGHBORHOOD_VN) {
+                nw = ne = sw = se = none;
+            } else if (hood == NEIGHBORHOOD_HEX) {
+                ne = sw = none;
+            }
+            Lanes sa, ca, sb, cb, sm, cm, c1, t, c2, c3, p[4], v;
+            FULL_ADD(sa, ca, nw, a[x], ne);
+            FULL_ADD(sb, cb, sw, b[x], se);
+            HALF_ADD(sm, cm, c[w], c[e]);
+            FULL_ADD(p[0], c1, sa, sb, sm);
+            FULL_ADD(t, c2, ca, cb, cm);
+            HALF_ADD(p[1], c3, t, c1);
+            HALF_ADD(p[2], p[3], c2, c3);
+            lanes_apply(&ensemble_rule, &c[x], p, &v);
+            next[(y * n) + x] = v;
+            moved |= v ^ c[x];
+            moved2 |= v ^ prev[(y * n) + x];
+
+            Lanes carry = v;
+            for (int i = 0; i < 4; i++) {
+                HALF_ADD(small[i], carry, small[i], carry);
+            }
+            if (++added == 15 || (y == n-1 && x == n-1)) {
+                carry = none;
+                for (int i = 0; i < ENSEMBLE_BITS; i++) {
+                    FULL_ADD(wide[i], carry, wide[i], (i < 4) ? small[i] : none, carry);
+                }
+                memset(small, 0, sizeof(small));
+                added = 0;
+            }
+        }
+    }
+    g->cells[0] = next;
+    g->cells[1] = cur;
+    g->cells[2] = prev;
+
+    for (int k = 0; k < ENSEMBLE_LANES; k++) {
+        if (!((g->running[k / 64] >> (k % 64)) & 1)) {
+            continue;
+        }
+        EnsembleBoard *s = &ensemble_states[(task * ENSEMBLE_LANES) + k];
+        s->pop = 0;
+        for (int i = 0; i < ENSEMBLE_BITS; i++) {
+            s->pop |= lane_get(&wide[i], k) << i;
+        }
+        s->period = (s->pop == 0) ? 0 : !lane_get(&moved, k) ? 1 : !lane_get(&moved2, k) ? 2 : -1;
+        if (s->period >= 0) {
+            s->end = ensemble_gen + 1;
+            g->running[k / 64] &= ~(1ULL << (k % 64));
+        }
+    }
+}
+
+/**
+* @brief fills every board with its own soup and transposes them into the lanes
+* @return true if the arguments were valid
+*/
+bool ensemble_init(int argc, char **argv) {
+    if (!parse_rule((argc > 0) ? argv[0] : "B3/S23", &ensemble_rule)) {
+        return false;
+    }
+    ensemble_boards = (argc > 1) ? atoi(argv[1]) : ENSEMBLE_LANES;
+    ensemble_size = (argc > 2) ? atoi(argv[2]) : 16;
+    if (ensemble_boards < 1 || ensemble_size < 3 || ensemble_size > ENSEMBLE_MAX) {
+        fprintf(stderr, "[E] An ensemble needs at least one board of 3x3 to %dx%d\n",
+                ENSEMBLE_MAX, ENSEMBLE_MAX);
+        return false;
+    }
+    ensemble_gen = 0;
+    ensemble_view = 0;
+    ensemble_page = 1;
+    ensemble_group_count = (ensemble_boards + ENSEMBLE_LANES - 1) / ENSEMBLE_LANES;
+    ensemble_groups = (EnsembleGroup*) calloc(ensemble_group_count, sizeof(EnsembleGroup));
+    ensemble_states = (EnsembleBoard*) calloc(ensemble_boards, sizeof(EnsembleBoard));
+    if (!ensemble_groups || !ensemble_states) {
+        fprintf(stderr, "Error allocating memory for the ensemble\n");
+        return false;
+    }
+    size_t bytes = (size_t) ensemble_size * ensemble_size * sizeof(Lanes);
+    for (int i = 0; i < ensemble_group_count; i++) {
+        for (int c = 0; c < 3; c++) {
+            ensemble_groups[i].cells[c] = (Lanes*) aligned_alloc(sizeof(Lanes), bytes);
+            if (!ensemble_groups[i].cells[c]) {
+                fprintf(stderr, "Error allocating memory for the ensemble\n");
+                return false;
+            }
+            memset(ensemble_groups[i].cells[c], 0, bytes);
+        }
+    }
+
+    Board b;
+    if (!board_init(&b, ensemble_size, ensemble_size)) {
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < ensemble_boards && ok; i++) {
+        EnsembleGroup *g = &ensemble_groups[i / ENSEMBLE_LANES];
+        int k = i % ENSEMBLE_LANES;
+        Soup s = soup;
+        s.seed = soup.seed + ((uint64_t) i * 0x9E3779B97F4A7C15ULL);
+        memset(b.data, 0, (size_t) (b.height + 2) * b.words * sizeof(uint64_t));
+        ok = soup_fill(&b, &s, 0, 0, ensemble_size, ensemble_size);
+        int pop = 0;
+        for (int y = 0; y < ensemble_size; y++) {
+            for (int x = 0; x < ensemble_size; x++) {
+                if (board_get(&b, x, y)) {
+                    g->cells[0][(y * ensemble_size) + x][k / 64] |= 1ULL << (k % 64);
+                    pop++;
+                }
+            }
+        }
+        g->running[k / 64] |= 1ULL << (k % 64);
+        ensemble_states[i] = (EnsembleBoard) { pop, -1, 0 };
+    }
+    board_destroy(&b);
+    return ok;
+}
+
+void ensemble_step() {
+    run_parallel(ensemble_group_count, ensemble_task, NULL);
+    ensemble_gen++;
+}
+
+/**
+* @brief skips ahead once every board has terminated, nothing changes from then on
+*/
+long ensemble_skip(long gens) {
+    for (int i = 0; i < ensemble_boards; i++) {
+        if (ensemble_states[i].period < 0) {
+            return 0;
+        }
+    }
+    ensemble_gen += gens;
+    return gens;
+}
+
+/**
+* @brief pages through the boards with , and .
+*/
+void ensemble_key(char ch) {
+    if (ch == '.' && ensemble_view + ensemble_page < ensemble_boards) {
+        ensemble_view += ensemble_page;
+    } else if (ch == ',') {
+        ensemble_view = (ensemble_view > ensemble_page) ? ensemble_view - ensemble_page : 0;
+    }
+}
+
+/**
+* @brief draws as many boards as fit, starting at ensemble_view
+*/
+void ensemble_draw(Screen *scr) {
+    int tile = ensemble_size + 1;
+    int across = (scr->width / tile > 0) ? scr->width / tile : 1;
+    int down = (scr->height / tile > 0) ? scr->height / tile : 1;
+    ensemble_page = across * down;
+    for (int y = 0; y < scr->height; y++) {
+        for (int x = 0; x < scr->width; x++) {
+            int bx = x % tile, by = y % tile;
+            int board = ensemble_view + ((y / tile) * across) + (x / tile);
+            bool on = (x / tile < across) && bx < ensemble_size && by < ensemble_size
+                      && board < ensemble_boards && ensemble_cell(board, bx, by);
+            setScreenPixel(scr, x, y, on);
+        }
+    }
+}
+
+/**
+* @brief prints how the boards ended and the spread of their final densities
+*/
+void ensemble_report() {
+    int counts[4] = { 0 };  // running, died, period 1, period 2
+    double sum = 0, squares = 0, ends = 0;
+    for (int i = 0; i < ensemble_boards; i++) {
+        EnsembleBoard *s = &ensemble_states[i];
+        counts[s->period + 1]++;
+        double density = (double) s->pop / (ensemble_size * ensemble_size);
+        sum += density;
+        squares += density * density;
+        if (s->period >= 0) {
+            ends += s->end;
+        }
+    }
+    double mean = sum / ensemble_boards;
+    double var = (squares / ensemble_boards) - (mean * mean);
+    int done = ensemble_boards - counts[0];
+    printf("%d boards %dx%d after %ld generations: %d died, %d still, %d period 2, %d running\n",
+           ensemble_boards, ensemble_size, ensemble_size, ensemble_gen,
+           counts[1], counts[2], counts[3], counts[0]);
+    printf("final density %.4f sd %.4f, terminated at generation %.1f on average\n",
+           mean, sqrt((var > 0) ? var : 0), done ? ends / done : 0.0);
+}
+
+void ensemble_destroy() {
+    for (int i = 0; i < ensemble_group_count; i++) {
+        for (int c = 0; c < 3; c++) {
+            free(ensemble_groups[i].cells[c]);
+        }
+    }
+    free(ensemble_groups);
+    free(ensemble_states);
+    ensemble_groups = NULL;
+    ensemble_states = NULL;
+}
+
+/*
+* Object labels for the live board of an engine. Every row is cut into runs of live
+* cells and runs closer than object_gap cells, 1 for plain 8-connectivity, are joined
+* with union-find, always under the lower index so the labels come out the same for
+* any thread count. Bands of rows are labelled in parallel and their seams joined
+* after. Objects of up to 64x64 are named with the apgcodes of the soup search, a
+* cache of the shapes seen keeps that down to a lookup once the board settles.
+* Periods are only looked for up to OBJECT_MAX_PERIOD, on a board just big enough
+* for the shape to grow that long, and the TUI names at most OBJECT_BUDGET new
+* shapes a frame, so the transient fragments of an active soup stay cheap.
+*/
+#define OBJECT_CACHE       8192  // shapes remembered, a power of two
+#define OBJECT_MAX_PERIOD  16
+#define OBJECT_MARGIN      (OBJECT_MAX_PERIOD + 1)
+#define OBJECT_BUDGET      256   // new shapes named per frame in the TUI
+
+typedef struct {
+    int x0, y0, x1, y1;  // bounding box, x1 and y1 one past the end
+    int pop;
+    char code[SEARCH_CODE];  // apgcode, zz_LARGE if too big, zz_UNNAMED if out of budget
+} Object;
+
+typedef struct {
+    int x0, x1;  // live cells x0..x1-1
+    int next;    // next run of the same object, -1 at the end
+} Run;
+
+typedef struct {
+    bool used;
+    Shape shape;
+    char code[SEARCH_CODE];
+} ObjectName;
+
+int object_gap = 1;
+Object *objects;
+int object_count;
+Census object_census;
+
+Run *label_runs;
+int *label_parent;
+int *label_object;    // object of every root run
+int *label_heads;     // first and last run of every object
+int *label_tails;
+int *label_rows;      // first run of every row, height+1 entries
+size_t label_capacity;
+int label_height;
+ObjectName *object_names;
+int object_names_used;
+Board object_a, object_b;  // where new shapes are run, 64x64 plus the margins
+
+/**
+* @brief finds the root of a run, halving the path on the way
+*/
+int label_find(int i) {
+    while (label_parent[i] != i) {
+        label_parent[i] = label_parent[label_parent[i]];
+        i = label_parent[i];
+    }
+    return i;
+}
+
+void label_union(int i, int j) {
+    i = label_find(i);
+    j = label_find(j);
+    if (i < j) {
+        label_parent[j] = i;
+    } else if (j < i) {
+        label_parent[i] = j;
+    }
+}
+
+/**
+* @brief joins the runs of row ya with those of the earlier row yb within object_gap
+*/
+void label_join_rows(int ya, int yb) {
+    int i = label_rows[ya], ie = label_rows[ya+1];
+    int j = label_rows[yb], je = label_rows[yb+1];
+    while (i < ie && j < je) {
+        Run *a = &label_runs[i], *b = &label_runs[j];
+        if (a->x1 - 1 + object_gap < b->x0) {
+            i++;
+        } else if (b->x1 - 1 + object_gap < a->x0) {
+            j++;
+        } else {
+            label_union(i, j);
+            if (a->x1 < b->x1) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+    }
+}
+
+/**
+* @brief the first cells of the runs in a word of a row
+*/
+static inline uint64_t run_starts(const uint64_t *row, int w) {
+    return row[w] & ~((row[w] << 1) | ((w > 0) ? row[w-1] >> 63 : 0));
+}
+
+static inline uint64_t run_ends(const uint64_t *row, int w, int words) {
+    return row[w] & ~((row[w] >> 1) | ((w+1 < words) ? row[w+1] << 63 : 0));
+}
+
+typedef struct {
+    const Board *b;
+    int bands;
+    bool fill;  // false to count the runs of every row, true to store and join them
+} LabelJob;
+
+void label_task(int task, void *arg) {
+    LabelJob *job = (LabelJob*) arg;
+    const Board *b = job->b;
+    int y0 = (b->height * task) / job->bands;
+    int y1 = (b->height * (task+1)) / job->bands;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *row = board_row(b, y);
+        if (!job->fill) {
+            int count = 0;
+            for (int w = 0; w < b->words; w++) {
+                count += __builtin_popcountll(run_starts(row, w));
+            }
+            label_rows[y+1] = count;
+            continue;
+        }
+        int r = label_rows[y], start = 0;
+        for (int w = 0; w < b->words; w++) {
+            uint64_t starts = run_starts(row, w), ends = run_ends(row, w, b->words);
+            while (starts | ends) {
+                // a run that started in an earlier word ends before the next start here
+                int s = starts ? __builtin_ctzll(starts) : 64;
+                int e = ends ? __builtin_ctzll(ends) : 64;
+                if (s <= e && starts) {
+                    start = (w*64) + s;
+                    starts &= starts - 1;
+                } else {
+                    label_runs[r] = (Run) { start, (w*64) + e + 1, -1 };
+                    label_parent[r] = r;
+                    if (r > label_rows[y] && start - (label_runs[r-1].x1 - 1) <= object_gap) {
+                        label_union(r-1, r);
+                    }
+                    r++;
+                    ends &= ends - 1;
+                }
+            }
+        }
+        for (int k = 1; k <= object_gap && y-k >= y0; k++) {
+            label_join_rows(y, y-k);
+        }
+    }
+}
+
+/**
+* @brief names a shape from the cache, running it on the scratch boards if it is new
+* @param budget new shapes that may still be run, decremented, negative for no limit
+* @return the code, NULL if the shape is new and the budget is spent
+*/
+const char *object_name(const Rule *rule, const Shape *s, int *budget) {
+    uint64_t h = ((uint64_t) s->w << 32) | (uint64_t) s->h;
+    for (int y = 0; y < s->h; y++) {
+        h = (h ^ s->rows[y]) * 0x9E3779B97F4A7C15ULL;
+    }
+    size_t i = (h >> 20) & (OBJECT_CACHE - 1);
+    while (object_names[i].used && !shape_equal(&object_names[i].shape, s)) {
+        i = (i + 1) & (OBJECT_CACHE - 1);
+    }
+    ObjectName *n = &object_names[i];
+    if (n->used) {
+        return n->code;
+    }
+    if (*budget == 0) {
+        return NULL;
+    }
+    (*budget)--;
+    if (object_names_used * 2 >= OBJECT_CACHE) {
+        memset(object_names, 0, OBJECT_CACHE * sizeof(ObjectName));
+        object_names_used = 0;
+    }
+
+    // the scratch boards are cut down to the shape and its margins
+    int width = s->w + (2 * OBJECT_MARGIN), height = s->h + (2 * OBJECT_MARGIN);
+    int words = (width + 63) / 64;
+    Board a = { width, height, words, object_a.data }, b = { width, height, words, object_b.data };
+    memset(a.data, 0, (size_t) (height + 2) * words * sizeof(uint64_t));
+    memset(b.data, 0, (size_t) (height + 2) * words * sizeof(uint64_t));
+    for (int y = 0; y < s->h; y++) {
+        for (int x = 0; x < s->w; x++) {
+            if ((s->rows[y] >> x) & 1) {
+                board_set(&a, OBJECT_MARGIN + x, OBJECT_MARGIN + y, true);
+            }
+        }
+    }
+    n->used = true;
+    n->shape = *s;
+    search_classify(rule, &a, &b, OBJECT_MAX_PERIOD, n->code);
+    object_names_used++;
+    return n->code;
+}
+
+/**
+* @brief labels the objects of a board, names them and counts them in object_census
+* @param budget new shapes that may be named, negative for all of them
+* @return false if memory ran out
+*/
+bool objects_label(const Board *b, const Rule *rule, int budget) {
+    if (!object_names) {
+        object_names = (ObjectName*) calloc(OBJECT_CACHE, sizeof(ObjectName));
+        int side = 64 + (2 * OBJECT_MARGIN);
+        if (!object_names || !board_init(&object_a, side, side) || !board_init(&object_b, side, side)) {
+            fprintf(stderr, "Error allocating memory for the object labels\n");
+            return false;
+        }
+    }
+    if (label_height < b->height) {
+        free(label_rows);
+        label_rows = (int*) malloc((b->height + 1) * sizeof(int));
+        if (!label_rows) {
+            fprintf(stderr, "Error allocating memory for the object labels\n");
+            return false;
+        }
+        label_height = b->height;
+    }
+    int bands = b->height / 64;
+    bands = (bands < 1) ? 1 : (bands > thread_count * 4) ? thread_count * 4 : bands;
+    LabelJob job = { b, bands, false };
+    run_parallel(bands, label_task, &job);
+    label_rows[0] = 0;
+    for (int y = 0; y < b->height; y++) {
+        label_rows[y+1] += label_rows[y];
+    }
+    size_t runs = label_rows[b->height];
+    if (runs > label_capacity) {
+        free(label_runs);
+        free(label_parent);
+        free(label_object);
+        free(label_heads);
+        free(label_tails);
+        free(objects);
+        label_capacity = runs + (runs / 2);
+        label_runs = (Run*) malloc(label_capacity * sizeof(Run));
+        label_parent = (int*) malloc(label_capacity * sizeof(int));
+        label_object = (int*) malloc(label_capacity * sizeof(int));
+        label_heads = (int*) malloc(label_capacity * sizeof(int));
+        label_tails = (int*) malloc(label_capacity * sizeof(int));
+        objects = (Object*) malloc(label_capacity * sizeof(Object));
+        if (!label_runs || !label_parent || !label_object || !label_heads || !label_tails || !objects) {
+            fprintf(stderr, "Error allocating memory for the object labels\n");
+            label_capacity = 0;
+            return false;
+        }
+    }
+    job.fill = true;
+    run_parallel(bands, label_task, &job);
+    for (int t = 1; t < bands; t++) {
+        int y0 = (b->height * t) / bands;
+        for (int y = y0; y < y0 + object_gap && y < b->height; y++) {
+            for (int k = 1; k <= object_gap && y-k >= 0; k++) {
+                if (y-k < y0) {
+                    label_join_rows(y, y-k);
+                }
+            }
+        }
+    }
+
+    // roots come first in their object, so objects appear in the order of their top left
+    // run, and the runs of each object are chained through the last one seen
+    object_count = 0;
+    for (int y = 0; y < b->height; y++) {
+        for (int i = label_rows[y]; i < label_rows[y+1]; i++) {
+            Run *r = &label_runs[i];
+            int root = label_find(i), o;
+            if (root == i) {
+                o = object_count++;
+                label_object[i] = o;
+                label_heads[o] = i;
+                label_tails[o] = i;
+                objects[o] = (Object) { r->x0, y, r->x1, y+1, 0, "" };
+            } else {
+                o = label_object[root];
+                label_runs[label_tails[o]].next = i;
+                label_tails[o] = i;
+            }
+            Object *obj = &objects[o];
+            obj->x0 = (r->x0 < obj->x0) ? r->x0 : obj->x0;
+            obj->x1 = (r->x1 > obj->x1) ? r->x1 : obj->x1;
+            obj->y1 = y+1;
+            obj->pop += r->x1 - r->x0;
+        }
+    }
+
+    census_clear(&object_census);
+    for (int o = 0; o < object_count; o++) {
+        Object *obj = &objects[o];
+        if (obj->x1 - obj->x0 > 64 || obj->y1 - obj->y0 > 64) {
+            strcpy(obj->code, "zz_LARGE");
+        } else {
+            Shape s = { obj->x1 - obj->x0, obj->y1 - obj->y0, obj->x0, obj->y0, obj->pop, { 0 } };
+            int y = obj->y0;
+            for (int i = label_heads[o]; i >= 0; i = label_runs[i].next) {
+                while (i >= label_rows[y+1]) {
+                    y++;
+                }
+                Run *r = &label_runs[i];
+                int len = r->x1 - r->x0;
+                s.rows[y - obj->y0] |= ((len == 64) ? ~0ULL : ((1ULL << len) - 1)) << (r->x0 - obj->x0);
+            }
+            const char *code = object_name(rule, &s, &budget);
+            strcpy(obj->code, code ? code : "zz_UNNAMED");
+        }
+        if (!census_add(&object_census, obj->code, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+* @brief outlines the cells x0 to x1-1 and y0 to y1-1 of a board, as board_draw shows it
+*/
+void board_draw_box(const Board *b, char neighborhood, Screen *scr, int x0, int y0, int x1, int y1) {
+    int xc = b->width / 2, yc = b->height / 2;
+    for (int by = y0 - 1; by <= y1; by++) {
+        for (int bx = x0 - 1; bx <= x1; bx++) {
+            if (by != y0 - 1 && by != y1 && bx != x0 - 1 && bx != x1) {
+                continue;
+            }
+            int y = by - yc + (scr->height / 2);
+            int x = (neighborhood == NEIGHBORHOOD_HEX) ? (2 * (bx - xc)) - (by - yc) + (scr->width / 2)
+                                                       : bx - xc + (scr->width / 2);
+            if (x >= 0 && x < scr->width && y >= 0 && y < scr->height) {
+                setScreenPixel(scr, x, y, true);
+            }
+        }
+    }
+}
+
+/**
+* @brief outlines every object over a board drawn with board_draw
+*/
+void objects_draw(const Board *b, char neighborhood, Screen *scr) {
+    for (int o = 0; o < object_count; o++) {
+        Object *obj = &objects[o];
+        board_draw_box(b, neighborhood, scr, obj->x0, obj->y0, obj->x1, obj->y1);
+    }
+}
+
+/**
+* @brief prints the object count and the most common objects
+* @param all true to print every code, false for the ten most common
+*/
+void objects_print(bool all) {
+    census_sort(&object_census);
+    printf("%d objects, %zu distinct\n", object_count, object_census.used);
+    for (size_t i = 0; i < object_census.used && (all || i < 10); i++) {
+        printf("%10ld %s\n", object_census.entries[i].count, object_census.entries[i].code);
+    }
+}
+
+void objects_destroy() {
+    free(label_runs);
+    free(label_parent);
+    free(label_object);
+    free(label_heads);
+    free(label_tails);
+    free(label_rows);
+    free(objects);
+    free(object_names);
+    label_runs = NULL;
+    label_parent = NULL;
+    label_object = NULL;
+    label_heads = NULL;
+    label_tails = NULL;
+    label_rows = NULL;
+    objects = NULL;
+    object_names = NULL;
+    label_capacity = 0;
+    label_height = 0;
+    object_count = 0;
+    object_names_used = 0;
+    census_clear(&object_census);
+    board_destroy(&object_a);
+    board_destroy(&object_b);
+}
+
+/*
+* Pattern search on the live board of an engine. A pattern is compiled into templates,
+* one per orientation and phase, each a list of cells that must be live or dead. A
+* template is tried at 64 positions of a row at once: every cell ANDs in the board
+* word shifted by its offset, or its complement, and the position word is dropped as
+* soon as it is empty. Live cells go first since they reject the most. Bands of rows
+* are searched in parallel and their matches joined in order.
+*
+* Patterns are given as rows such as .o./..o/ooo, with o or * for live, . or b for
+* dead and ? for either, or as an apgcode such as xq4_153. Patterns without ? are
+* lone objects: their phases under the rule are searched too, each inside a ring of
+* dead cells. Patterns with ? are matched as written, in every orientation.
+*/
+#define FIND_MAX_SIZE    62  // cells per side of a pattern or phase, so its ring fits a word
+#define FIND_MAX_PHASES  16
+#define FIND_TEMPLATES   (8 * FIND_MAX_PHASES)
+
+typedef struct {
+    int w, h;
+    uint64_t on[64];    // live cells
+    uint64_t care[64];  // cells that have to match, live or dead
+} FindPattern;
+
+typedef struct {
+    int dx, dy;  // from the top left of the match
+    bool live;
+} FindCell;
+
+typedef struct {
+    int w, h;      // size of the match, every live cell is inside it
+    int phase, orient;
+    int count;
+    FindCell *cells;  // live cells first
+} FindTemplate;
+
+typedef struct {
+    int x, y;
+    int template;
+} FindMatch;
+
+typedef struct {
+    FindMatch *matches;
+    int count, capacity;
+    bool failed;
+} FindBand;
+
+char find_spec[64];
+FindTemplate find_templates[FIND_TEMPLATES];
+int find_template_count;
+FindMatch *find_matches;
+int find_count;
+FindBand find_bands[MAX_THREADS * 4];
+
+/**
+* @brief reads a pattern given as rows, o or * live, . or b dead and ? for either
+* @return false if the pattern was invalid or larger than FIND_MAX_SIZE
+*/
+bool find_parse_rows(const char *spec, FindPattern *p, bool *literal) {
+    memset(p, 0, sizeof(*p));
+    *literal = false;
+    int x = 0;
+    p->h = 1;
+    for (const char *c = spec; *c; c++) {
+        if (*c == '/' || *c == '$') {
+            if (++p->h > FIND_MAX_SIZE) {
+                fprintf(stderr, "[E] Pattern larger than %dx%d: %s\n", FIND_MAX_SIZE, FIND_MAX_SIZE, spec);
+                return false;
+            }
+            x = 0;
+            continue;
+        }
+        if (x >= FIND_MAX_SIZE || p->h > FIND_MAX_SIZE || !strchr("o*.b?", *c)) {
+            fprintf(stderr, "[E] Invalid pattern: %s\n", spec);
+            return false;
+        }
+        if (*c == '?') {
+            *literal = true;
+        } else {
+            p->care[p->h-1] |= 1ULL << x;
+        }
+        if (*c == 'o' || *c == '*') {
+            p->on[p->h-1] |= 1ULL << x;
+        }
+        x++;
+        p->w = (x > p->w) ? x : p->w;
+    }
+    return true;
+}
+
+/**
+* @brief reads the live cells of an apgcode such as xq4_153 or xs4_33
+* @return false if the code was invalid or larger than FIND_MAX_SIZE
+*/
+bool find_parse_code(const char *spec, FindPattern *p) {
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    memset(p, 0, sizeof(*p));
+    const char *c = strchr(spec, '_');
+    int x = 0, strip = 0;
+    for (c = c ? c+1 : spec; *c; c++) {
+        const char *d = strchr(digits, *c);
+        if (*c == 'z') {
+            strip += 5;
+            x = 0;
+        } else if (*c == 'w' || *c == 'x') {
+            x += (*c == 'w') ? 2 : 3;
+        } else if (*c == 'y' && c[1] && strchr(digits, c[1])) {
+            x += 4 + (int) (strchr(digits, c[1]) - digits);
+            c++;
+        } else if (d && d - digits < 32) {
+            for (int k = 0; k < 5; k++) {
+                if (((d - digits) >> k) & 1) {
+                    if (x >= FIND_MAX_SIZE || strip+k >= FIND_MAX_SIZE) {
+                        fprintf(stderr, "[E] Pattern larger than %dx%d: %s\n", FIND_MAX_SIZE, FIND_MAX_SIZE, spec);
+                        return false;
+                    }
+                    p->on[strip+k] |= 1ULL << x;
+                    p->w = (x+1 > p->w) ? x+1 : p->w;
+                    p->h = (strip+k+1 > p->h) ? strip+k+1 : p->h;
+                }
+            }
+            x++;
+        } else {
+            fprintf(stderr, "[E] Invalid apgcode: %s\n", spec);
+            return false;
+        }
+    }
+    for (int y = 0; y < p->h; y++) {
+        p->care[y] = (1ULL << p->w) - 1;
+    }
+    return p->h > 0;
+}
+
+/**
+* @brief adds a pattern under one orientation as a template, unless an equal one exists
+* @param p the pattern
+* @param ring true to require a ring of dead cells around it
+* @param orient bit 0 flips x, bit 1 flips y, bit 2 swaps x and y first
+* @return false if memory ran out
+*/
+bool find_add(const FindPattern *p, bool ring, int phase, int orient) {
+    FindTemplate *t = &find_templates[find_template_count];
+    t->w = (orient & 4) ? p->h : p->w;
+    t->h = (orient & 4) ? p->w : p->h;
+    t->phase = phase;
+    t->orient = orient;
+    t->count = 0;
+    t->cells = (FindCell*) malloc((size_t) (t->w + 2) * (t->h + 2) * sizeof(FindCell));
+    if (!t->cells) {
+        fprintf(stderr, "Error allocating memory for a pattern\n");
+        return false;
+    }
+    int r = ring ? 1 : 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int y = -r; y < t->h + r; y++) {
+            for (int x = -r; x < t->w + r; x++) {
+                int tx = (orient & 1) ? t->w-1-x : x;
+                int ty = (orient & 2) ? t->h-1-y : y;
+                int sx = (orient & 4) ? ty : tx;
+                int sy = (orient & 4) ? tx : ty;
+                bool inside = sx >= 0 && sx < p->w && sy >= 0 && sy < p->h;
+                bool care = !inside || ((p->care[sy] >> sx) & 1);
+                bool live = inside && ((p->on[sy] >> sx) & 1);
+                if (care && live == (pass == 0)) {
+                    t->cells[t->count++] = (FindCell) { x, y, live };
+                }
+            }
+        }
+    }
+    for (int i = 0; i < find_template_count; i++) {
+        FindTemplate *u = &find_templates[i];
+        bool same = u->w == t->w && u->h == t->h && u->count == t->count;
+        for (int c = 0; same && c < t->count; c++) {
+            same = u->cells[c].dx == t->cells[c].dx && u->cells[c].dy == t->cells[c].dy
+                && u->cells[c].live == t->cells[c].live;
+        }
+        if (same) {
+            free(t->cells);
+            return true;
+        }
+    }
+    find_template_count++;
+    return true;
+}
+
+/**
+* @brief compiles a pattern into the templates of all its orientations and phases
+* @param spec the pattern, as rows or as an apgcode
+* @param rule the rule the phases are found under
+* @return false if the pattern was invalid or memory ran out
+*/
+bool find_compile(const char *spec, const Rule *rule) {
+    FindPattern p;
+    bool literal = false;
+    if ((spec[0] == 'x' && strchr(spec, '_')) ? !find_parse_code(spec, &p)
+                                              : !find_parse_rows(spec, &p, &literal)) {
+        return false;
+    }
+    // hexagonal boards are skewed, only the half turn keeps their neighborhood
+    int orients = (rule->neighborhood == NEIGHBORHOOD_HEX) ? 2 : 8;
+    find_template_count = 0;
+    snprintf(find_spec, sizeof(find_spec), "%s", spec);
+    if (literal) {
+        for (int o = 0; o < orients; o++) {
+            if (!find_add(&p, false, 0, (o == 1 && orients == 2) ? 3 : o)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the phases are found by running the pattern alone until it repeats
+    int size = FIND_MAX_SIZE + (2 * FIND_MAX_PHASES) + 2;
+    Board a, b;
+    if (!board_init(&a, size, size) || !board_init(&b, size, size)) {
+        return false;
+    }
+    for (int y = 0; y < p.h; y++) {
+        for (int x = 0; x < p.w; x++) {
+            if ((p.on[y] >> x) & 1) {
+                board_set(&a, FIND_MAX_PHASES + 1 + x, FIND_MAX_PHASES + 1 + y, true);
+            }
+        }
+    }
+    Shape phases[FIND_MAX_PHASES + 1];  // phase g after g steps, the last one only to compare
+    int period = 0;
+    bool live = shape_from_board(&a, &phases[0]);
+    for (int g = 1; live && g <= FIND_MAX_PHASES && !period; g++) {
+        board_step(rule, &a, &b);
+        Board t = a;
+        a = b;
+        b = t;
+        Shape *s = &phases[g];
+        if (!shape_from_board(&a, s) || s->w > FIND_MAX_SIZE || s->h > FIND_MAX_SIZE) {
+            break;
+        }
+        if (shape_equal(s, &phases[0])) {
+            period = g;
+        }
+    }
+    board_destroy(&a);
+    board_destroy(&b);
+    if (!live) {
+        fprintf(stderr, "[E] Pattern has no live cells: %s\n", spec);
+        return false;
+    }
+
+    // patterns that do not repeat in time are only looked for as they are
+    period = period ? period : 1;
+    for (int ph = 0; ph < period; ph++) {
+        FindPattern q = { phases[ph].w, phases[ph].h, { 0 }, { 0 } };
+        for (int y = 0; y < q.h; y++) {
+            q.on[y] = phases[ph].rows[y];
+            q.care[y] = (1ULL << q.w) - 1;
+        }
+        for (int o = 0; o < orients; o++) {
+            if (!find_add(&q, true, ph, (o == 1 && orients == 2) ? 3 : o)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+* @brief reads 64 cells of a row starting dx cells after word k, cells off the board are dead
+*/
+static inline uint64_t find_window(const uint64_t *row, int k, int dx, int words) {
+    if (dx == 0) {
+        return row[k];
+    }
+    if (dx > 0) {
+        return (row[k] >> dx) | ((k+1 < words) ? row[k+1] << (64 - dx) : 0);
+    }
+    return (row[k] << -dx) | ((k > 0) ? row[k-1] >> (64 + dx) : 0);
+}
+
+/**
+* @brief keeps a match found by a band
+* @return false if memory ran out
+*/
+bool find_keep(FindBand *band, int x, int y, int template) {
+    if (band->count == band->capacity) {
+        int capacity = band->capacity ? band->capacity * 2 : 64;
+        FindMatch *matches = (FindMatch*) realloc(band->matches, capacity * sizeof(FindMatch));
+        if (!matches) {
+            band->failed = true;
+            return false;
+        }
+        band->matches = matches;
+        band->capacity = capacity;
+    }
+    band->matches[band->count++] = (FindMatch) { x, y, template };
+    return true;
+}
+
+typedef struct {
+    const Board *b;
+    int rows;  // rows per band
+} FindJob;
+
+/**
+* @brief finds the matches whose top row is in one band
+*/
+void find_task(int task, void *arg) {
+    FindJob *job = (FindJob*) arg;
+    const Board *b = job->b;
+    FindBand *band = &find_bands[task];
+    band->count = 0;
+    band->failed = false;
+    int y0 = task * job->rows;
+    int y1 = (y0 + job->rows < b->height) ? y0 + job->rows : b->height;
+    for (int y = y0; y < y1; y++) {
+        for (int i = 0; i < find_template_count; i++) {
+            const FindTemplate *t = &find_templates[i];
+            int positions = b->width - t->w + 1;
+            if (y + t->h > b->height || positions <= 0) {
+                continue;
+            }
+            for (int k = 0; k * 64 < positions; k++) {
+                uint64_t m = (positions - (k * 64) >= 64) ? ~0ULL : (1ULL << (positions - (k * 64))) - 1;
+                for (int c = 0; c < t->count && m; c++) {
+                    uint64_t v = find_window(board_row(b, y + t->cells[c].dy), k, t->cells[c].dx, b->words);
+                    m &= t->cells[c].live ? v : ~v;
+                }
+                for (; m; m &= m - 1) {
+                    if (!find_keep(band, (k * 64) + __builtin_ctzll(m), y, i)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+* @brief finds every match of the compiled pattern on a board
+* @return false if memory ran out
+*/
+bool find_run(const Board *b) {
+    int tasks = (thread_count * 4 < b->height) ? thread_count * 4 : b->height;
+    FindJob job = { b, (b->height + tasks - 1) / tasks };
+    tasks = (b->height + job.rows - 1) / job.rows;
+    run_parallel(tasks, find_task, &job);
+
+    int total = 0;
+    for (int i = 0; i < tasks; i++) {
+        if (find_bands[i].failed) {
+            fprintf(stderr, "Error allocating memory for the matches\n");
+            return false;
+        }
+        total += find_bands[i].count;
+    }
+    FindMatch *matches = (FindMatch*) realloc(find_matches, (total ? total : 1) * sizeof(FindMatch));
+    if (!matches) {
+        fprintf(stderr, "Error allocating memory for the matches\n");
+        return false;
+    }
+    find_matches = matches;
+    find_count = 0;
+    for (int i = 0; i < tasks; i++) {
+        memcpy(&find_matches[find_count], find_bands[i].matches, find_bands[i].count * sizeof(FindMatch));
+        find_count += find_bands[i].count;
+    }
+    return true;
+}
+
+/**
+* @brief outlines every match over a board drawn with board_draw
+*/
+void find_draw(const Board *b, char neighborhood, Screen *scr) {
+    for (int i = 0; i < find_count; i++) {
+        const FindMatch *m = &find_matches[i];
+        const FindTemplate *t = &find_templates[m->template];
+        board_draw_box(b, neighborhood, scr, m->x, m->y, m->x + t->w, m->y + t->h);
+    }
+}
+
+/**
+* @brief prints the match count
+* @param all true to also print where every match is, with its phase and orientation
+*/
+void find_print(bool all) {
+    printf("%d matches of %s\n", find_count, find_spec);
+    for (int i = 0; all && i < find_count; i++) {
+        const FindMatch *m = &find_matches[i];
+        const FindTemplate *t = &find_templates[m->template];
+        printf("%6d %6d phase %d orientation %d\n", m->x, m->y, t->phase, t->orient);
+    }
+}
+
+void find_destroy() {
+    for (int i = 0; i < find_template_count; i++) {
+        free(find_templates[i].cells);
+    }
+    for (int i = 0; i < MAX_THREADS * 4; i++) {
+        free(find_bands[i].matches);
+        find_bands[i] = (FindBand) { NULL, 0, 0, false };
+    }
+    free(find_matches);
+    find_matches = NULL;
+    find_template_count = 0;
+    find_count = 0;
+}
+
+/*
+* Edit scripts, one edit per line: the generation it is for, then one of
+*   set x y [0|1]        fill x y w h [0|1]        clear        paste x y pattern
+* with patterns written as for -f, ? cells are left as they are, and the clipboard
+*   copy x y w h         rotate 90|180|270         mirror x|y         transpose
+*   paste x y [or|xor|and|copy]
+* where a paste without a pattern puts down the clipboard, or'ed by default. A script
+* is read by its own thread as the board runs. When it is a file the step loop keeps
+* behind the generations read so far, so every edit lands on its generation; through a
+* pipe the board never waits and an edit that arrives late is applied at the next
+* generation.
+* Lines are expected in order of generation, an edit waits for every edit before it.
+*/
+#define EDIT_SCRIPT   0  // the rings, one per producer
+#define EDIT_KEYS     1
+#define EDIT_SOURCES  2
+
+EditQueue edit_queues[EDIT_SOURCES];
+atomic_bool edit_script_running;
+atomic_long edit_script_read;  // generation of the last edit queued, all earlier ones are in
+bool edit_script_file;         // true to keep the step loop behind the reading
+
+/**
+* @brief sets up a paste of a pattern given as for -f
+* @return false if the pattern was invalid
+*/
+bool edit_paste(Edit *e, const char *spec, int x, int y) {
+    FindPattern p;
+    bool literal;
+    if ((spec[0] == 'x' && strchr(spec, '_')) ? !find_parse_code(spec, &p)
+                                              : !find_parse_rows(spec, &p, &literal)) {
+        return false;
+    }
+    e->op = EDIT_PASTE;
+    e->x = x;
+    e->y = y;
+    e->w = p.w;
+    e->h = p.h;
+    memcpy(e->on, p.on, sizeof(e->on));
+    memcpy(e->mask, p.care, sizeof(e->mask));
+    return true;
+}
+
+/**
+* @brief parses the mode of a clipboard paste
+* @return one of the PASTE_ modes, -1 if it is none
+*/
+int edit_paste_mode(const char *mode) {
+    const char *names[] = { "or", "xor", "and", "copy" };
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(mode, names[i]) == 0) {
+            return PASTE_OR + i;
+        }
+    }
+    return -1;
+}
+
+/**
+* @brief parses one line of an edit script
+* @return false if the line was invalid
+*/
+bool edit_parse(const char *line, Edit *e) {
+    char op[16], spec[256];
+    int n = 0, k, value = 1;
+    memset(e, 0, sizeof(*e));
+    if (sscanf(line, " %ld %15s %n", &e->gen, op, &n) < 2 || e->gen < 0) {
+        return false;
+    }
+    const char *args = line + n;
+    if (strcmp(op, "set") == 0 && sscanf(args, "%d %d %d", &e->x, &e->y, &value) >= 2) {
+        e->op = EDIT_SET;
+    } else if (strcmp(op, "fill") == 0 && sscanf(args, "%d %d %d %d %d", &e->x, &e->y, &e->w, &e->h, &value) >= 4) {
+        e->op = EDIT_FILL;
+    } else if (strcmp(op, "clear") == 0) {
+        *e = (Edit) { .op = EDIT_FILL, .gen = e->gen, .w = board_width, .h = board_height };
+        value = 0;
+    } else if (strcmp(op, "paste") == 0 && (k = sscanf(args, "%d %d %255s", &e->x, &e->y, spec)) >= 2) {
+        if (k == 3 && edit_paste_mode(spec) < 0) {
+            return edit_paste(e, spec, e->x, e->y);
+        }
+        e->op = EDIT_CLIP;
+        e->mode = (k == 3) ? edit_paste_mode(spec) : PASTE_OR;
+    } else if (strcmp(op, "copy") == 0 && sscanf(args, "%d %d %d %d", &e->x, &e->y, &e->w, &e->h) == 4) {
+        e->op = EDIT_COPY;
+    } else if (strcmp(op, "rotate") == 0 && sscanf(args, "%d", &value) == 1) {
+        e->op = EDIT_ORIENT;
+        e->mode = (value == 90) ? 5 : (value == 180) ? 3 : (value == 270) ? 6 : -1;
+        return e->mode >= 0;
+    } else if (strcmp(op, "mirror") == 0 && sscanf(args, "%15s", spec) == 1
+               && (strcmp(spec, "x") == 0 || strcmp(spec, "y") == 0)) {
+        e->op = EDIT_ORIENT;
+        e->mode = (spec[0] == 'x') ? 1 : 2;
+    } else if (strcmp(op, "transpose") == 0) {
+        e->op = EDIT_ORIENT;
+        e->mode = 4;
+    } else {
+        return false;
+    }
+    e->value = value != 0;
+    return true;
+}
+
+/**
+* @brief reads an edit script and queues its edits, waiting whenever the ring is full
+*/
+void *edit_script_thread(void *arg) {
+    FILE *f = (FILE*) arg;
+    char line[512];
+    int number = 0;
+    while (fgets(line, sizeof(line), f)) {
+        number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[strspn(line, " \t")] == '\0' || line[strspn(line, " \t")] == '#') {
+            continue;
+        }
+        Edit e;
+        if (!edit_parse(line, &e)) {
+            fprintf(stderr, "[E] Invalid edit on line %d: %s\n", number, line);
+            continue;
+        }
+        while (!edit_push(&edit_queues[EDIT_SCRIPT], &e)) {
+            usleep(1000);
+        }
+        atomic_store(&edit_script_read, e.gen);
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    atomic_store(&edit_script_running, false);
+    return NULL;
+}
+
+/**
+* @brief starts the thread reading an edit script
+* @param path the script, - for stdin
+* @return false if it could not be opened
+*/
+bool edit_script_start(const char *path) {
+    FILE *f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[E] Cannot open edit script %s\n", path);
+        return false;
+    }
+    struct stat st;
+    edit_script_file = fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode);
+    pthread_t thread;
+    atomic_store(&edit_script_read, -1);
+    atomic_store(&edit_script_running, true);
+    if (pthread_create(&thread, NULL, edit_script_thread, f) != 0) {
+        fprintf(stderr, "[E] Cannot start the edit script thread\n");
+        atomic_store(&edit_script_running, false);
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+/**
+* @brief applies the queued edits that are due, between two generations
+* @param engine the engine, its edit hook receives them
+* @param gen the generation about to be stepped
+* @return the first generation another edit could be due at, LONG_MAX if none can come
+*/
+long edits_apply(Engine *engine, long gen) {
+    long next = LONG_MAX;
+    for (int i = 0; i < EDIT_SOURCES; i++) {
+        const Edit *e;
+        for (;;) {
+            // read first, so every edit the reader had queued by then gets applied
+            bool running = (i == EDIT_SCRIPT) && atomic_load(&edit_script_running);
+            long read = atomic_load(&edit_script_read);
+            while ((e = edit_peek(&edit_queues[i])) && e->gen <= gen) {
+                engine->edit(e);
+                edit_pop(&edit_queues[i]);
+            }
+            if (e || !running) {
+                break;
+            }
+            if (!edit_script_file) {
+                next = gen + 1;  // a pipe may still send anything
+                break;
+            }
+            if (read > gen) {
+                next = (read < next) ? read : next;
+                break;
+            }
+            sched_yield();
+        }
+        if (e) {
+            next = (e->gen < next) ? e->gen : next;
+        }
+    }
+    return next;
+}
+
+Engine engines[] = {
+    { .name = "life", .usage = "",
+      .init = life_init, .step = life_step, .draw = life_draw, .destroy = life_destroy,
+      .key = life_key },
+    { .name = "ltl", .usage = "[R5,C0,M1,S34..58,B34..45,NM]",
+      .init = ltl_init, .step = ltl_step, .draw = ltl_draw, .destroy = ltl_destroy },
+    { .name = "lenia", .usage = "[R13,m0.15,s0.017,T10,D1]",
+      .init = lenia_init, .step = lenia_step, .draw = lenia_draw, .destroy = lenia_destroy },
+    { .name = "bits", .usage = "[B3/S23|B2/S34H|B2/S013V] [pb=1] [ps=1] [noise=0] [seed=0]",
+      .init = bits_init, .step = bits_step, .draw = bits_draw, .destroy = bits_destroy,
+      .report = bits_report, .skip = bits_skip, .board = bits_board, .stats = bits_get_stats,
+      .edit = bits_edit },
+    { .name = "life3d", .usage = "[4555] [size]",
+      .init = life3d_init, .step = life3d_step, .draw = life3d_draw, .destroy = life3d_destroy,
+      .key = life3d_key },
+    { .name = "table", .usage = "<file.rule|file.table>",
+      .init = table_init, .step = table_step, .draw = table_draw, .destroy = table_destroy },
+    { .name = "wireworld", .usage = "[circuit.rle|circuit.txt]",
+      .init = ww_init, .step = ww_step, .draw = ww_draw, .destroy = ww_destroy },
+    { .name = "margolus", .usage = "[critters|bbm|tron|MS,D...]",
+      .init = block_init, .step = block_step, .draw = block_draw, .destroy = block_destroy,
+      .key = block_key },
+    { .name = "eca", .usage = "[110|T20R2|all] [single]",
+      .init = eca_init, .step = eca_step, .draw = eca_draw, .destroy = eca_destroy,
+      .report = eca_report },
+    { .name = "branch", .usage = "[B3/S23] [gen] [B36/S23][:x,y...]...",
+      .init = branch_init, .step = branch_step, .draw = branch_draw, .destroy = branch_destroy,
+      .key = branch_key, .report = branch_report },
+    { .name = "search", .usage = "[B3/S23] [census.txt]",
+      .init = search_init, .step = search_step, .draw = search_draw, .destroy = search_destroy,
+      .report = search_report },
+    { .name = "methuselah", .usage = "[B3/S23] [5x5] [random|enum] [methuselah.ckpt]",
+      .init = meth_init, .step = meth_step, .draw = meth_draw, .destroy = meth_destroy,
+      .report = meth_report },
+    { .name = "rules", .usage = "[explore [all|rules.txt] [rules.bin]|browse [rules.bin]]",
+      .init = rules_init, .step = rules_step, .draw = rules_draw, .destroy = rules_destroy,
+      .key = rules_key, .report = rules_report },
+    { .name = "ensemble", .usage = "[B3/S23] [boards] [size]",
+      .init = ensemble_init, .step = ensemble_step, .draw = ensemble_draw, .destroy = ensemble_destroy,
+      .key = ensemble_key, .report = ensemble_report, .skip = ensemble_skip },
+};
+#define ENGINE_COUNT (sizeof(engines) / sizeof(engines[0]))
+
+void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s WxH] [-t threads] [-n gens] [-d density] [-S seed] [-Y symmetry]"
+                    " [-c every[,gap]] [-f pattern[,every]] [-e script] [engine] [engine arguments]\n", prog);
+    fprintf(stderr, "  -n runs gens generations without the terminal and prints the timing\n");
+    fprintf(stderr, "  -c labels the objects of the board every so many generations of a -n run (0 for\n"
+                    "     the end only) and prints the census, gap joins cells that far apart, o in the TUI\n");
+    fprintf(stderr, "  -f finds a pattern such as .o./..o/ooo or xq4_153 in every orientation and phase,\n"
+                    "     ? for cells that can be either, at the end of a -n run and every so often, m in the TUI\n");
+    fprintf(stderr, "  -e reads edits from a script (- for stdin) while the board runs, one per line:\n"
+                    "     gen set x y [0|1], gen fill x y w h [0|1], gen clear or gen paste x y pattern;\n"
+                    "     the clipboard with gen copy x y w h, gen rotate 90|180|270, gen mirror x|y,\n"
+                    "     gen transpose and gen paste x y [or|xor|and|copy];\n"
+                    "     x clears the board and v pastes the -f pattern or a glider in the TUI,\n"
+                    "     y copies what is shown, t turns the copy clockwise and p puts it back\n");
+    fprintf(stderr, "  -d, -S and -Y set the starting soup, e.g. -d 3/8 -S 42 -Y C4 (C1, C2, C4 or D8)\n");
+    fprintf(stderr, "engines:\n");
+    for (size_t i = 0; i < ENGINE_COUNT; i++) {
+        fprintf(stderr, "  %s %s\n", engines[i].name, engines[i].usage);
+    }
+}
+
+int main(int argc, char **argv) {
+    bool running = true;
+    Engine *engine = &engines[0];
+    long gens = -1;
+    long census_every = -1;
+    bool labels_shown = false;
+    const char *find_pattern = NULL;
+    long find_every = -1;
+    bool matches_shown = false;
+    const char *edit_script = NULL;
+
+    thread_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    int opt;
+    while ((opt = getopt(argc, argv, "+s:t:n:d:S:Y:c:f:e:")) != -1) {
+        switch (opt) {
+            case 's':
+                if (sscanf(optarg, "%dx%d", &board_width, &board_height) != 2
+                    || board_width <= 0 || board_height <= 0) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 't':
+                thread_count = atoi(optarg);
+                if (thread_count < 1 || thread_count > MAX_THREADS) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'n':
+                gens = atol(optarg);
+                if (gens < 0) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'd':
+                if (!parse_density(optarg, &soup.density)) {
+                    return 1;
+                }
+                break;
+            case 'S':
+                soup.seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'Y':
+                if (!parse_symmetry(optarg, &soup.symmetry)) {
+                    return 1;
+                }
+                break;
+            case 'c':
+                if (sscanf(optarg, "%ld,%d", &census_every, &object_gap) < 1
+                    || census_every < 0 || object_gap < 1) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'f': {
+                // the pattern never holds a comma, so the last one starts the interval
+                char *comma = strrchr(optarg, ',');
+                find_every = 0;
+                if (comma) {
+                    *comma = '\0';
+                    find_every = atol(comma+1);
+                }
+                find_pattern = optarg;
+                if (find_every < 0 || !find_pattern[0]) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            }
+            case 'e':
+                edit_script = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind < argc) {
+        engine = NULL;
+        for (size_t i = 0; i < ENGINE_COUNT; i++) {
+            if (strcmp(argv[optind], engines[i].name) == 0) {
+                engine = &engines[i];
+            }
+        }
+        if (!engine) {
+            usage(argv[0]);
+            return 1;
+        }
+        optind++;
+    }
+    if (!engine->init(argc - optind, argv + optind)) {
+        return 1;
+    }
+    if (find_pattern) {
+        const Rule *rule;
+        if (!engine->board) {
+            fprintf(stderr, "[E] %s has no bit packed board to search\n", engine->name);
+            return 1;
+        }
+        engine->board(&rule);
+        if (!find_compile(find_pattern, rule)) {
+            return 1;
+        }
+    }
+    if (edit_script) {
+        if (!engine->edit) {
+            fprintf(stderr, "[E] %s cannot be edited\n", engine->name);
+            return 1;
+        }
+        if (!edit_script_start(edit_script)) {
+            return 1;
+        }
+    }
+
+    // headless run
+    if (gens >= 0) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        long next_census = census_every;
+        long next_find = find_every;
+        for (long g = 0; g < gens; g++) {
+            long next_edit = engine->edit ? edits_apply(engine, g) : LONG_MAX;
+            engine->step();
+            if (engine->skip) {
+                // whole cycles are only jumped up to the next edit
+                long limit = gens - g - 1;
+                limit = (next_edit - g - 1 < limit) ? next_edit - g - 1 : limit;
+                g += engine->skip(limit);
+            }
+            if (census_every > 0 && engine->board && g+1 >= next_census) {
+                const Rule *rule;
+                const Board *b = engine->board(&rule);
+                if (!objects_label(b, rule, -1)) {
+                    return 1;
+                }
+                printf("generation %ld: %d objects, %zu distinct\n", g+1, object_count, object_census.used);
+                next_census = g + 1 + census_every;
+            }
+            if (find_every > 0 && g+1 >= next_find) {
+                const Rule *rule;
+                const Board *b = engine->board(&rule);
+                if (!find_run(b)) {
+                    return 1;
+                }
+                printf("generation %ld: %d matches\n", g+1, find_count);
+                next_find = g + 1 + find_every;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double secs = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1e9);
+        printf("%ld generations in %.3fs (%.1f gens/s)\n", gens, secs, (secs > 0) ? gens / secs : 0);
+        if (engine->stats) {
+            const StepStats *st = engine->stats();
+            printf("generation %ld: population %ld, %ld births and %ld deaths in the last step\n",
+                   st->gen, st->pop, st->births, st->deaths);
+        }
+        if (engine->report) {
+            engine->report();
+        }
+        if (census_every >= 0 && engine->board) {
+            const Rule *rule;
+            const Board *b = engine->board(&rule);
+            if (!objects_label(b, rule, -1)) {
+                return 1;
+            }
+            objects_print(true);
+        }
+        if (find_pattern) {
+            const Rule *rule;
+            const Board *b = engine->board(&rule);
+            if (!find_run(b)) {
+                return 1;
+            }
+            find_print(true);
+        }
+        objects_destroy();
+        find_destroy();
+        engine->destroy();
+        return 0;
+    }
+
+    // load temporary stdout buffer
+    init_term();
+
+    // current screen instance
+    Screen scr;
+
+    if (returnError(initScreen(&scr, 0x0, 100, 100))) {
+        exit(1);
+    }
+    long gen = 0;
+
+    while (running) {
+        char key = getch();
+        if (key == 'q') {
+            running = false;
+        } else if (key == 'o' && engine->board) {
+            labels_shown = !labels_shown;
+        } else if (key == 'm' && find_pattern) {
+            matches_shown = !matches_shown;
+        } else if ((key == 'x' || key == 'v') && engine->edit) {
+            // key edits go through their own ring, due at once
+            Edit e = { .op = EDIT_FILL, .w = board_width, .h = board_height };
+            if (key == 'x' || edit_paste(&e, find_pattern ? find_pattern : ".o./..o/ooo",
+                                         board_width / 2, board_height / 2)) {
+                edit_push(&edit_queues[EDIT_KEYS], &e);
+            }
+        } else if ((key == 'y' || key == 't' || key == 'p') && engine->edit) {
+            // the clipboard: copy what is shown, turn it clockwise, put it back centred
+            Edit e = { .op = EDIT_COPY, .x = (board_width - scr.width) / 2, .y = (board_height - scr.height) / 2,
+                       .w = scr.width, .h = scr.height };
+            if (key == 't') {
+                e = (Edit) { .op = EDIT_ORIENT, .mode = 5 };
+            } else if (key == 'p') {
+                e = (Edit) { .op = EDIT_CLIP, .mode = PASTE_COPY, .x = (board_width - clipboard.width) / 2,
+                             .y = (board_height - clipboard.height) / 2 };
+            }
+            edit_push(&edit_queues[EDIT_KEYS], &e);
+        } else if (key != 0 && engine->key) {
+            engine->key(key);
+        }
+
+        // GOL loop
+        if (engine->edit) {
+            edits_apply(engine, gen);
+        }
+        engine->step();
+        gen++;
+        scr.flags &= ~SCREEN_SELF_RENDER;
+        engine->draw(&scr);
+        if (labels_shown) {
+            const Rule *rule;
+            const Board *b = engine->board(&rule);
+            if (objects_label(b, rule, OBJECT_BUDGET)) {
+                objects_draw(b, rule->neighborhood, &scr);
+            }
+        }
+        if (matches_shown) {
+            const Rule *rule;
+            const Board *b = engine->board(&rule);
+            if (find_run(b)) {
+                find_draw(b, rule->neighborhood, &scr);
+            }
+        }
+        // render
+        if (!(scr.flags & SCREEN_SELF_RENDER)) {
+            renderScreen(&scr);
+        }
+        printScreen(&scr);
+        if (engine->stats) {
+            // the HUD goes on the line under the screen
+            const StepStats *st = engine->stats();
+            char hud[128];
+            snprintf(hud, sizeof(hud), "gen %ld  pop %ld  births %ld  deaths %ld    ",
+                     st->gen, st->pop, st->births, st->deaths);
+            printXY((scr.height / 3) + 3, 2, hud);
+            fflush(stdout);
+        }
         usleep(100 * 1000); // Sleep 10ms
     }
 
     // clean up
+    objects_destroy();
+    find_destroy();
+    engine->destroy();
     destroyScreen(&scr);
 
     // return to original stdout